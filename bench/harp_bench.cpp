@@ -0,0 +1,346 @@
+/**
+ * @file
+ * @brief harp_bench: headless benchmark harness for HARP's hot paths.
+ *
+ * Drives the non-GUI work the app actually spends its time on - MIDI parse
+ * into the piano roll, the temp-file undo chain, waveform thumbnail scans,
+ * and (optionally, given a live gradio endpoint) the full model round-trip -
+ * with warmup and repetitions, and emits JSON that CI can diff run-to-run.
+ *
+ * Usage:
+ *   harp_bench [--reps N] [--warmup N] [--json out.json] [--large]
+ *              [--url <gradio space url>]
+ *
+ * --large adds the big cases (1M-note MIDI, 1 GB media) that are too slow
+ * for a per-commit CI run. --url enables the WebModel load/process bench
+ * against the given (usually locally mocked) gradio server.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "juce_audio_formats/juce_audio_formats.h"
+#include "juce_gui_basics/juce_gui_basics.h"
+
+#include "../src/WebModel.h"
+#include "../src/media/MediaDisplayComponent.h"
+#include "../src/media/MidiDisplayComponent.h"
+
+using namespace juce;
+
+
+//==============================================================================
+// timing and reporting
+
+struct BenchHarness {
+    BenchHarness(int _reps, int _warmup) : reps(_reps), warmup(_warmup) {}
+
+    // runs fn (warmup + reps) times and records min/mean/max wall time.
+    // setUp runs before every iteration and is not timed.
+    void run(const String& name,
+             std::function<void()> fn,
+             std::function<void()> setUp = nullptr)
+    {
+        std::vector<double> timesMs;
+
+        for (int i = 0; i < warmup + reps; ++i) {
+            if (setUp) {
+                setUp();
+            }
+
+            int64 t0 = Time::getHighResolutionTicks();
+            fn();
+            int64 t1 = Time::getHighResolutionTicks();
+
+            if (i >= warmup) {
+                timesMs.push_back(Time::highResolutionTicksToSeconds(t1 - t0) * 1000.0);
+            }
+        }
+
+        double minMs = timesMs[0], maxMs = timesMs[0], sumMs = 0.0;
+
+        for (double t : timesMs) {
+            minMs = jmin(minMs, t);
+            maxMs = jmax(maxMs, t);
+            sumMs += t;
+        }
+
+        double meanMs = sumMs / (double) timesMs.size();
+
+        std::cout << name << ": mean " << String(meanMs, 3) << " ms"
+                  << " (min " << String(minMs, 3)
+                  << ", max " << String(maxMs, 3)
+                  << ", n=" << reps << ")" << std::endl;
+
+        DynamicObject::Ptr result = new DynamicObject();
+        result->setProperty("name", name);
+        result->setProperty("reps", reps);
+        result->setProperty("warmup", warmup);
+        result->setProperty("min_ms", minMs);
+        result->setProperty("mean_ms", meanMs);
+        result->setProperty("max_ms", maxMs);
+        results.append(var(result.get()));
+    }
+
+    var toJson() const
+    {
+        DynamicObject::Ptr report = new DynamicObject();
+        report->setProperty("timestamp", Time::getCurrentTime().toISO8601(true));
+        report->setProperty("results", results);
+        return var(report.get());
+    }
+
+    int reps;
+    int warmup;
+    var results;
+};
+
+
+//==============================================================================
+// synthetic inputs
+
+static File getScratchDirectory()
+{
+    File dir = File::getSpecialLocation(File::tempDirectory).getChildFile("harp_bench");
+    dir.createDirectory();
+    return dir;
+}
+
+// a pseudo-random MIDI performance with the note density of a real one
+static File makeSyntheticMidiFile(int numNotes)
+{
+    File midiPath = getScratchDirectory().getChildFile("synthetic_" + String(numNotes) + ".mid");
+
+    if (midiPath.existsAsFile()) {
+        return midiPath;
+    }
+
+    Random random(42);
+    MidiMessageSequence track;
+
+    const int ticksPerQuarter = 960;
+
+    for (int i = 0; i < numNotes; ++i) {
+        int note = 24 + random.nextInt(72);
+        int velocity = 1 + random.nextInt(127);
+        double startTick = (double) (i * 120 + random.nextInt(60));
+        double durationTicks = (double) (60 + random.nextInt(4 * ticksPerQuarter));
+
+        track.addEvent(MidiMessage::noteOn(1, note, (uint8) velocity), startTick);
+        track.addEvent(MidiMessage::noteOff(1, note), startTick + durationTicks);
+    }
+
+    track.updateMatchedPairs();
+
+    MidiFile midiFile;
+    midiFile.setTicksPerQuarterNote(ticksPerQuarter);
+    midiFile.addTrack(track);
+
+    FileOutputStream stream(midiPath);
+    midiFile.writeTo(stream);
+
+    return midiPath;
+}
+
+// an uncompressed sine-sweep wav of roughly the requested size
+static File makeSyntheticWavFile(int64 approxBytes)
+{
+    File wavPath = getScratchDirectory().getChildFile("synthetic_" + String(approxBytes) + ".wav");
+
+    if (wavPath.existsAsFile()) {
+        return wavPath;
+    }
+
+    const double sampleRate = 44100.0;
+    const int numChannels = 2;
+    const int bytesPerFrame = numChannels * 2; // 16-bit
+    const int64 numFrames = approxBytes / bytesPerFrame;
+
+    WavAudioFormat format;
+    std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(
+        new FileOutputStream(wavPath), sampleRate, (unsigned int) numChannels, 16, {}, 0));
+
+    const int blockSize = 1 << 16;
+    AudioBuffer<float> block(numChannels, blockSize);
+
+    for (int64 framesWritten = 0; framesWritten < numFrames; framesWritten += blockSize) {
+        int framesThisBlock = (int) jmin((int64) blockSize, numFrames - framesWritten);
+
+        for (int i = 0; i < framesThisBlock; ++i) {
+            double phase = (double) (framesWritten + i) * 440.0 / sampleRate;
+            float sample = (float) std::sin(phase * MathConstants<double>::twoPi);
+
+            for (int ch = 0; ch < numChannels; ++ch) {
+                block.setSample(ch, i, sample);
+            }
+        }
+
+        writer->writeFromAudioSampleBuffer(block, 0, framesThisBlock);
+    }
+
+    return wavPath;
+}
+
+
+//==============================================================================
+// a minimal concrete display, so the temp-file chain can be driven without
+// audio devices or a window
+
+class BenchMediaDisplay : public MediaDisplayComponent {
+public:
+    void drawMainArea(Graphics&, Rectangle<int>&) override {}
+    StringArray getInstanceExtensions() override { return {}; }
+    void loadMediaFile(const URL&) override {}
+    void setPlaybackPosition(double) override {}
+    double getPlaybackPosition() override { return 0.0; }
+    void startPlaying() override {}
+    void stopPlaying() override {}
+    bool isPlaying() override { return false; }
+    double getTotalLengthInSecs() override { return 0.0; }
+
+private:
+    void resetDisplay() override {}
+    void postLoadActions(const URL&) override {}
+};
+
+
+//==============================================================================
+// benchmarks
+
+static void benchMidiParse(BenchHarness& harness, int numNotes)
+{
+    File midiPath = makeSyntheticMidiFile(numNotes);
+
+    harness.run("midi_parse_" + String(numNotes) + "_notes", [&midiPath] {
+        MidiDisplayComponent display;
+        display.loadMediaFile(URL(midiPath));
+    });
+}
+
+static void benchTempFileChain(BenchHarness& harness, int64 mediaBytes)
+{
+    File wavPath = makeSyntheticWavFile(mediaBytes);
+
+    BenchMediaDisplay display;
+
+    harness.run("temp_file_chain_" + File::descriptionOfSizeInBytes(mediaBytes).replaceCharacter(' ', '_'),
+        [&display] {
+            display.addNewTempFile();
+        },
+        [&display, &wavPath] {
+            // a fresh chain every iteration, so each rep measures the same
+            // first step instead of ever-longer chains
+            display.setupDisplay(URL(wavPath));
+        });
+}
+
+static void benchThumbnailScan(BenchHarness& harness, AudioFormatManager& formatManager)
+{
+    File wavPath = makeSyntheticWavFile(10 * 1024 * 1024);
+
+    harness.run("thumbnail_scan_10_MB", [&formatManager, &wavPath] {
+        // a fresh cache per iteration forces a full rescan
+        AudioThumbnailCache cache(8);
+        AudioThumbnail thumbnail(512, formatManager, cache);
+        thumbnail.setSource(new FileInputSource(wavPath));
+
+        while (!thumbnail.isFullyLoaded()) {
+            Thread::sleep(1);
+        }
+    });
+}
+
+static void benchModelRoundTrip(BenchHarness& harness, const String& url)
+{
+    WebModel model;
+
+    std::cout << "loading model from " << url << "..." << std::endl;
+
+    harness.run("model_load", [&model, &url] {
+        model.load({{"url", url.toStdString()}});
+    });
+
+    File wavPath = makeSyntheticWavFile(1024 * 1024);
+    File processPath = getScratchDirectory().getChildFile("roundtrip" + wavPath.getFileExtension());
+
+    harness.run("model_process_1_MB",
+        [&model, &processPath] {
+            model.process(processPath);
+        },
+        [&wavPath, &processPath] {
+            // process() replaces its input, so give it a fresh copy each time
+            processPath.deleteFile();
+            wavPath.copyFileTo(processPath);
+        });
+}
+
+
+//==============================================================================
+
+int main(int argc, char* argv[])
+{
+    // the bench usually runs headless (CI boxes without a GL stack), so GPU
+    // compositing in the displays defaults off here; exporting the variable
+    // explicitly before launch still wins
+    if (SystemStats::getEnvironmentVariable("HARP_NO_OPENGL", "").isEmpty()) {
+       #if JUCE_WINDOWS
+        _putenv_s("HARP_NO_OPENGL", "1");
+       #else
+        setenv("HARP_NO_OPENGL", "1", 1);
+       #endif
+    }
+
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    ArgumentList args(argc, argv);
+
+    int reps = args.containsOption("--reps") ? args.getValueForOption("--reps").getIntValue() : 5;
+    int warmup = args.containsOption("--warmup") ? args.getValueForOption("--warmup").getIntValue() : 1;
+    bool large = args.containsOption("--large");
+    String url = args.getValueForOption("--url");
+    String jsonPath = args.getValueForOption("--json");
+
+    BenchHarness harness(jmax(1, reps), jmax(0, warmup));
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    benchMidiParse(harness, 10'000);
+    benchMidiParse(harness, 100'000);
+
+    benchTempFileChain(harness, 10 * 1024 * 1024);
+    benchTempFileChain(harness, 100 * 1024 * 1024);
+
+    benchThumbnailScan(harness, formatManager);
+
+    if (large) {
+        benchMidiParse(harness, 1'000'000);
+        benchTempFileChain(harness, (int64) 1024 * 1024 * 1024);
+    }
+
+    if (url.isNotEmpty()) {
+        try {
+            benchModelRoundTrip(harness, url);
+        } catch (const std::exception& e) {
+            std::cerr << "model round-trip bench failed: " << e.what() << std::endl;
+        }
+    } else {
+        std::cout << "(skipping model round-trip - pass --url <gradio space> to enable)" << std::endl;
+    }
+
+    String json = JSON::toString(harness.toJson());
+
+    if (jsonPath.isNotEmpty()) {
+        File(File::getCurrentWorkingDirectory().getChildFile(jsonPath)).replaceWithText(json);
+        std::cout << "wrote " << jsonPath << std::endl;
+    } else {
+        std::cout << json << std::endl;
+    }
+
+    getScratchDirectory().deleteRecursively();
+
+    return 0;
+}
@@ -2,6 +2,7 @@ import argparse
 from gradio_client import Client, handle_file
 from pathlib import Path
 import json
+import shutil
 import signal
 import time
 
@@ -25,18 +26,29 @@ signal.signal(signal.SIGINT, handler_stop_signals)
 signal.signal(signal.SIGTERM, handler_stop_signals)
 
 def main(
-        url: str, 
-        output_path: str, 
-        mode: str, 
-        ctrls_path : str = None, 
+        url: str,
+        output_path: str,
+        mode: str,
+        ctrls_path : str = None,
         ctrls_timeout: float = 30,
         cancel_flag_path: str = None,
-        status_flag_path: str = None
+        status_flag_path: str = None,
+        status_callback=None,
+        cancel_poll=None,
+        partial_callback=None,
     ):
     assert url, "Please specify a url to connect to."
     assert output_path, "Please specify an output path."
     global client
     client = Client(url)
+
+    def report_status(status: str):
+        # push the status over the socket when we have one (daemon mode);
+        # otherwise fall back to the status flag file
+        if status_callback is not None:
+            status_callback(status)
+        elif status_flag_path is not None:
+            Path(status_flag_path).write_text(status)
     
     if mode == "controls":
         print(f"Getting controls for {url}...")
@@ -54,7 +66,7 @@ def main(
                 # TODO - better api naming scheme (i.e. cancel)
                 client.submit(api_name="/wav2wav-cancel")
                 canceled = True
-                Path(status_flag_path).write_text("Status.CANCELED")
+                report_status("Status.CANCELED")
                 # break
                 raise TimeoutError("Timeout of {ctrls_timeout} seconds reached. Cancelling...")
 
@@ -64,7 +76,10 @@ def main(
         print(f"got ctrls: {ctrls}")
         # if it's a string, it's a filepath
         if isinstance(ctrls, str):
-            Path(ctrls).rename(output_path)
+            # shutil.move, not Path.rename: gradio_client downloads into a
+            # /tmp-based dir while output_path may live on another mount
+            # (e.g. /dev/shm); os.rename across mounts raises EXDEV
+            shutil.move(ctrls, str(output_path))
         # if it's not, likely that it's the actual controls
         else:
             print(f"Saving ctrls to {output_path}...")
@@ -93,34 +108,67 @@ def main(
         job = client.submit(*ctrls, api_name="/wav2wav")
 
         canceled = False
+        last_status = None
+
+        # spaces that yield intermediate results surface them through
+        # job.outputs(); each one becomes a playable "prefix" file next to
+        # the final output, swapped in atomically so a reader never sees a
+        # half-written file
+        partial_path = str(output_path) + ".partial"
+        seen_outputs = 0
+
         while not job.done():
-            # check if the cancel flag exists
-            # if it does, cancel the job
-            if cancel_flag_path is not None:
-                if Path(cancel_flag_path).exists():
-                    print("Cancel flag detected. Cancelling...")
-                    # TODO - better api naming scheme (i.e. cancel)
-                    client.submit(api_name="/wav2wav-cancel")
-                    canceled = True
-                    Path(status_flag_path).write_text("Status.CANCELED")
-                    break
-            
-            # check if we were given a status path
-            # if it does, write the status to the file
+            # a pushed cancel message (daemon mode) takes effect immediately;
+            # the cancel flag file remains as the one-shot fallback
+            cancel_requested = cancel_poll() if cancel_poll is not None else False
+
+            if not cancel_requested and cancel_flag_path is not None:
+                cancel_requested = Path(cancel_flag_path).exists()
+
+            if cancel_requested:
+                print("Cancel requested. Cancelling...")
+                # TODO - better api naming scheme (i.e. cancel)
+                client.submit(api_name="/wav2wav-cancel")
+                canceled = True
+                report_status("Status.CANCELED")
+                break
+
             status = job.status()
             print(f"Status: {status}")
 
-            if status_flag_path is not None:
-                Path(status_flag_path).write_text(str(status.code))
-        
+            # only report on change, so the push channel isn't flooded
+            code = str(status.code)
+            if code != last_status:
+                report_status(code)
+                last_status = code
+
+            outputs = job.outputs()
+            if len(outputs) > seen_outputs:
+                seen_outputs = len(outputs)
+                latest = outputs[-1]
+                if isinstance(latest, str) and Path(latest).exists():
+                    tmp_path = partial_path + ".tmp"
+                    shutil.copyfile(latest, tmp_path)
+                    Path(tmp_path).replace(partial_path)
+                    print(f"Saved partial output {seen_outputs} to {partial_path}")
+                    if partial_callback is not None:
+                        partial_callback(partial_path)
+
             time.sleep(0.05)
-        
+
         if not canceled:
             audio_path = job.result()
 
             print(f"Saving audio to {output_path}...")
-            Path(audio_path).rename(output_path)
-        else:
+            # cross-mount safe (see the controls branch above)
+            shutil.move(audio_path, str(output_path))
+
+        # the completed prefix is superseded by the final output (or moot
+        # after a cancel) - never leave it behind to confuse the next run
+        if Path(partial_path).exists():
+            Path(partial_path).unlink()
+
+        if canceled:
             # still consume the result and block? 
             # job.result()
             pass
@@ -130,16 +178,108 @@ def main(
 
     print("gradiojuce_client done! :)")
 
+
+def run_daemon(port: int):
+    # daemon mode: stay resident and serve "controls"/"process" requests over a
+    # local socket, so HARP doesn't pay the (PyInstaller) interpreter boot cost
+    # on every call. One JSON object per line in, one JSON object per line out.
+    import select
+    import socket
+    import traceback
+
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(("127.0.0.1", port))
+    server.listen(1)
+    print(f"gradiojuce_client daemon listening on 127.0.0.1:{port}")
+
+    while True:
+        conn, _ = server.accept()
+        rfile = conn.makefile("r", encoding="utf-8")
+        wfile = conn.makefile("w", encoding="utf-8")
+
+        for line in rfile:
+            line = line.strip()
+            if not line:
+                continue
+
+            try:
+                request = json.loads(line)
+            except json.JSONDecodeError:
+                continue
+
+            # a cancel pushed while nothing is in flight (e.g. the job was
+            # still queued on the HARP side) lands here instead of in
+            # cancel_poll below. Treating it as a request would emit a
+            # response line that the NEXT real request then consumes as its
+            # own reply, desynchronizing the protocol for good - so swallow
+            # it: there's nothing to cancel.
+            if request.get("mode") == "cancel":
+                print("Ignoring cancel message with no request in flight")
+                continue
+
+            def status_callback(status: str):
+                # push a status event line; the final response line is the
+                # only one without a "type" key
+                wfile.write(json.dumps({"type": "status", "status": status}) + "\n")
+                wfile.flush()
+
+            def partial_callback(path: str):
+                # push a partial-output event line as each completed segment
+                # lands, so the app can show it right away
+                wfile.write(json.dumps({"type": "partial", "path": path}) + "\n")
+                wfile.flush()
+
+            def cancel_poll() -> bool:
+                # the client only ever writes a cancel message while a request
+                # is in flight, so anything arriving here is a cancel
+                readable, _, _ = select.select([conn], [], [], 0)
+                if readable:
+                    data = conn.recv(4096)
+                    return bool(data)
+                return False
+
+            response = {"exit_code": 0, "log": ""}
+            try:
+                main(
+                    url=request.get("url"),
+                    output_path=request.get("output_path"),
+                    mode=request.get("mode"),
+                    ctrls_path=request.get("ctrls_path"),
+                    cancel_flag_path=request.get("cancel_flag_path"),
+                    status_flag_path=request.get("status_flag_path"),
+                    status_callback=status_callback,
+                    cancel_poll=cancel_poll,
+                    partial_callback=partial_callback,
+                )
+            except Exception:
+                response["exit_code"] = 1
+                response["log"] = traceback.format_exc()
+
+            wfile.write(json.dumps(response) + "\n")
+            wfile.flush()
+
+        conn.close()
+
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description='Process some arguments.')
-    parser.add_argument('--url', required=True, help='The URL to connect to.')
-    parser.add_argument('--output_path', required=True, help='The output path to save the file.')
-    parser.add_argument('--mode', required=True, choices=['controls', 'process'], help='The mode of operation.')
+    parser.add_argument('--url', help='The URL to connect to.')
+    parser.add_argument('--output_path', help='The output path to save the file.')
+    parser.add_argument('--mode', required=True, choices=['controls', 'process', 'daemon'], help='The mode of operation.')
     parser.add_argument('--ctrls_path', help='The path to the controls file.')
     parser.add_argument('--cancel_flag_path', help='The path to the cancel flag file.')
     parser.add_argument('--status_flag_path', help='The path to the status flag file.')
     parser.add_argument('--ctrls_timeout', type=float, default=30, help='The timeout for getting controls.')
-    
+    parser.add_argument('--port', type=int, help='The local port to listen on (daemon mode).')
+
     args = parser.parse_args()
-    
-    main(**vars(args))
+
+    if args.mode == "daemon":
+        run_daemon(args.port)
+    else:
+        assert args.url, "Please specify a url to connect to."
+        assert args.output_path, "Please specify an output path."
+        kwargs = vars(args)
+        kwargs.pop("port")
+        main(**kwargs)
@@ -0,0 +1,121 @@
+/**
+ * @file
+ * @brief Asynchronous file logger. Producers append to a bounded in-memory
+ * queue and return immediately; a background thread batches the pending
+ * messages into a single append per wakeup. This keeps log calls off the
+ * hot path - a synchronous FileLogger append can block for milliseconds on
+ * a network home directory, right in the middle of process().
+ */
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "juce_core/juce_core.h"
+
+
+class AsyncLogger : private juce::Thread {
+public:
+  enum class Level {
+    debug = 0, // chatty per-event output, helper stdout dumps
+    info,      // normal progress messages
+    error
+  };
+
+  AsyncLogger(const juce::File& logFile, const juce::String& welcomeMessage)
+      : juce::Thread("harp async logger"), m_file(logFile) {
+    m_file.getParentDirectory().createDirectory();
+    m_file.appendText(welcomeMessage + juce::newLine);
+
+    startThread();
+  }
+
+  ~AsyncLogger() override {
+    signalThreadShouldExit();
+    notify();
+    stopThread(2000);
+
+    // whatever is still queued gets written on the caller's thread
+    flushPending();
+  }
+
+  juce::File getLogFile() const { return m_file; }
+
+  //! messages below this level are discarded at the call site. release
+  //! builds default to info, so the debug-heavy paths cost nothing there.
+  void setMinimumLevel(Level level) { m_minLevel = level; }
+
+  void logMessage(const juce::String& message, Level level = Level::info) {
+    if (level < m_minLevel.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    {
+      // the lock only covers the in-memory append - never any file I/O -
+      // so producers can't stall behind a slow disk
+      const juce::ScopedLock lock(m_queueLock);
+
+      if (m_pending.size() >= maxPending) {
+        // bounded memory: drop rather than grow, and say so in the log
+        ++m_dropped;
+        return;
+      }
+
+      m_pending.push_back(message);
+    }
+
+    notify();
+  }
+
+private:
+  void run() override {
+    while (!threadShouldExit()) {
+      wait(500);
+      flushPending();
+    }
+  }
+
+  void flushPending() {
+    std::vector<juce::String> batch;
+    juce::int64 dropped = 0;
+
+    {
+      const juce::ScopedLock lock(m_queueLock);
+      std::swap(batch, m_pending);
+      std::swap(dropped, m_dropped);
+    }
+
+    if (batch.empty() && dropped == 0) {
+      return;
+    }
+
+    juce::String out;
+
+    for (const auto& message : batch) {
+      out << message << juce::newLine;
+    }
+
+    if (dropped > 0) {
+      out << "(async logger dropped " << juce::String(dropped)
+          << " messages under load)" << juce::newLine;
+    }
+
+    // one append per batch, not one per message
+    m_file.appendText(out);
+  }
+
+  static constexpr size_t maxPending = 4096;
+
+  juce::File m_file;
+
+#if JUCE_DEBUG
+  std::atomic<Level> m_minLevel { Level::debug };
+#else
+  std::atomic<Level> m_minLevel { Level::info };
+#endif
+
+  juce::CriticalSection m_queueLock;
+  std::vector<juce::String> m_pending;
+  juce::int64 m_dropped { 0 };
+};
@@ -56,70 +56,71 @@ public:
       return;
     }
 
-    auto &ctrlList = mModel->controls();
-  
-    for (const auto &pair : ctrlList) {
-      auto ctrlPtr = pair.second;
-      // SliderCtrl
-        if (auto sliderCtrl = dynamic_cast<SliderCtrl*>(ctrlPtr.get())) {
-            auto sliderWithLabel = std::make_unique<SliderWithLabel>(sliderCtrl->label, juce::Slider::RotaryHorizontalVerticalDrag);
+    for (auto &ctrlVariant : mModel->controls()) {
+      std::visit([this](auto &ctrl) {
+        using T = std::decay_t<decltype(ctrl)>;
+
+        // SliderCtrl
+        if constexpr (std::is_same_v<T, SliderCtrl>) {
+            auto sliderWithLabel = std::make_unique<SliderWithLabel>(ctrl.label, juce::Slider::RotaryHorizontalVerticalDrag);
             // auto& label = sliderWithLabel->getLabel();
             // label.setColour(juce::Label::ColourIds::textColourId, mHARPLookAndFeel.textHeaderColor);
             auto& slider = sliderWithLabel->getSlider();
-            slider.setName(sliderCtrl->id.toString());
-            slider.setRange(sliderCtrl->minimum, sliderCtrl->maximum, sliderCtrl->step);
-            slider.setValue(sliderCtrl->value);
+            slider.setName(ctrl.id.toString());
+            slider.setRange(ctrl.minimum, ctrl.maximum, ctrl.step);
+            slider.setValue(ctrl.value);
             slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 80, 20);
             slider.addListener(this);
             addAndMakeVisible(*sliderWithLabel);
             sliders.push_back(std::move(sliderWithLabel));
-            DBG("Slider: " + sliderCtrl->label + " added");
-
-      // ToggleCtrl
-      } else if (auto toggleCtrl = dynamic_cast<ToggleCtrl*>(ctrlPtr.get())) {
-          auto toggle = std::make_unique<juce::ToggleButton>();
-          toggle->setName(toggleCtrl->id.toString());
-          toggle->setTitle(toggleCtrl->label);
-          toggle->setButtonText(toggleCtrl->label);
-          toggle->setToggleState(toggleCtrl->value, juce::dontSendNotification);
-          toggle->addListener(this);
-          addAndMakeVisible(*toggle);
-          toggles.push_back(std::move(toggle));
-          DBG("Toggle: " + toggleCtrl->label + " added");
-
-      // TextBoxCtrl
-      } else if (auto textBoxCtrl = dynamic_cast<TextBoxCtrl*>(ctrlPtr.get())) {
-          auto textCtrl = std::make_unique<TitledTextBox>();
-          textCtrl->setName(textBoxCtrl->id.toString());
-          textCtrl->setTitle(textBoxCtrl->label);
-          textCtrl->setText(textBoxCtrl->value);
-          textCtrl->addListener(this);
-          addAndMakeVisible(*textCtrl);
-          textCtrls.push_back(std::move(textCtrl));
-          DBG("Text Box: " + textBoxCtrl->label + " added");
-
-      // ComboBoxCtrl
-      } else if (auto comboBoxCtrl = dynamic_cast<ComboBoxCtrl*>(ctrlPtr.get())) {
-          auto comboBox = std::make_unique<juce::ComboBox>();
-          comboBox->setName(comboBoxCtrl->id.toString());
-          for (const auto &option : comboBoxCtrl->options) {
-              comboBox->addItem(option, comboBox->getNumItems() + 1);
-          }
-
-          int selectedId = 1; // Default to first item if the desired value isn't found
-          for (int i = 0; i < comboBox->getNumItems(); ++i) {
-              if (comboBox->getItemText(i).toStdString() == comboBoxCtrl->value) {
-                  selectedId = i + 1;  // item IDs start at 1
-                  break;
-              }
-          }
-          comboBox->addListener(this);
-          comboBox->setTextWhenNoChoicesAvailable("No choices");
-          addAndMakeVisible(*comboBox);
-          optionCtrls.push_back(std::move(comboBox));
-          DBG("Combo Box: " + comboBoxCtrl->label + " added");
-      }
-
+            DBG("Slider: " + ctrl.label + " added");
+
+        // ToggleCtrl
+        } else if constexpr (std::is_same_v<T, ToggleCtrl>) {
+            auto toggle = std::make_unique<juce::ToggleButton>();
+            toggle->setName(ctrl.id.toString());
+            toggle->setTitle(ctrl.label);
+            toggle->setButtonText(ctrl.label);
+            toggle->setToggleState(ctrl.value, juce::dontSendNotification);
+            toggle->addListener(this);
+            addAndMakeVisible(*toggle);
+            toggles.push_back(std::move(toggle));
+            DBG("Toggle: " + ctrl.label + " added");
+
+        // TextBoxCtrl
+        } else if constexpr (std::is_same_v<T, TextBoxCtrl>) {
+            auto textCtrl = std::make_unique<TitledTextBox>();
+            textCtrl->setName(ctrl.id.toString());
+            textCtrl->setTitle(ctrl.label);
+            textCtrl->setText(ctrl.value);
+            textCtrl->addListener(this);
+            addAndMakeVisible(*textCtrl);
+            textCtrls.push_back(std::move(textCtrl));
+            DBG("Text Box: " + ctrl.label + " added");
+
+        // ComboBoxCtrl
+        } else if constexpr (std::is_same_v<T, ComboBoxCtrl>) {
+            auto comboBox = std::make_unique<juce::ComboBox>();
+            comboBox->setName(ctrl.id.toString());
+            for (const auto &option : ctrl.options) {
+                comboBox->addItem(option, comboBox->getNumItems() + 1);
+            }
+
+            int selectedId = 1; // Default to first item if the desired value isn't found
+            for (int i = 0; i < comboBox->getNumItems(); ++i) {
+                if (comboBox->getItemText(i).toStdString() == ctrl.value) {
+                    selectedId = i + 1;  // item IDs start at 1
+                    break;
+                }
+            }
+            comboBox->addListener(this);
+            comboBox->setTextWhenNoChoicesAvailable("No choices");
+            addAndMakeVisible(*comboBox);
+            optionCtrls.push_back(std::move(comboBox));
+            DBG("Combo Box: " + ctrl.label + " added");
+        }
+        // AudioInCtrl / MidiInCtrl / NumberBoxCtrl get no widget here
+      }, ctrlVariant);
     }
     repaint();
     resized();
@@ -216,14 +217,12 @@ public:
   void buttonClicked(Button *button) override {
     auto id = juce::Uuid(button->getName().toStdString());
 
-    CtrlList &ctrls = mModel->controls();
-    auto pair = mModel->findCtrlByUuid(id); 
-    if (pair == ctrls.end()) {
+    auto ctrl = mModel->findCtrlByUuid(id);
+    if (ctrl == nullptr) {
       DBG("buttonClicked: ctrl not found");
       return;
     }
-    auto ctrl = pair->second;
-    if (auto toggleCtrl = dynamic_cast<ToggleCtrl*>(ctrl.get())) {
+    if (auto toggleCtrl = std::get_if<ToggleCtrl>(ctrl)) {
       toggleCtrl->value = button->getToggleState();
     } else {
       DBG("buttonClicked: ctrl is not a toggle");
@@ -234,14 +233,12 @@ public:
   void comboBoxChanged(ComboBox *comboBox) override {
     auto id = juce::Uuid(comboBox->getName().toStdString());
 
-    CtrlList &ctrls = mModel->controls();
-    auto pair = mModel->findCtrlByUuid(id);
-    if (pair == ctrls.end()) {
+    auto ctrl = mModel->findCtrlByUuid(id);
+    if (ctrl == nullptr) {
       DBG("comboBoxChanged: ctrl not found");
       return;
     }
-    auto ctrl = pair->second;
-    if (auto comboBoxCtrl = dynamic_cast<ComboBoxCtrl*>(ctrl.get())) {
+    if (auto comboBoxCtrl = std::get_if<ComboBoxCtrl>(ctrl)) {
       comboBoxCtrl->value = comboBox->getText().toStdString();
     } else {
       DBG("comboBoxChanged: ctrl is not a combobox");
@@ -251,14 +248,12 @@ public:
   void textEditorTextChanged (TextEditor& textEditor) override {
     auto id = juce::Uuid(textEditor.getName().toStdString());
 
-    CtrlList &ctrls = mModel->controls();
-    auto pair = mModel->findCtrlByUuid(id);
-    if (pair == ctrls.end()) {
+    auto ctrl = mModel->findCtrlByUuid(id);
+    if (ctrl == nullptr) {
       DBG("textEditorTextChanged: ctrl not found");
       return;
     }
-    auto ctrl = pair->second;
-    if (auto textBoxCtrl = dynamic_cast<TextBoxCtrl*>(ctrl.get())) {
+    if (auto textBoxCtrl = std::get_if<TextBoxCtrl>(ctrl)) {
       textBoxCtrl->value = textEditor.getText().toStdString();
     } else {
       DBG("textEditorTextChanged: ctrl is not a text box");
@@ -272,16 +267,14 @@ public:
   void sliderDragEnded(Slider* slider) override {
     auto id = juce::Uuid(slider->getName().toStdString());
 
-    CtrlList &ctrls = mModel->controls();
-    auto pair = mModel->findCtrlByUuid(id);
-    if (pair == ctrls.end()) {
+    auto ctrl = mModel->findCtrlByUuid(id);
+    if (ctrl == nullptr) {
       DBG("sliderDragEnded: ctrl not found");
       return;
     }
-    auto ctrl = pair->second;
-    if (auto sliderCtrl = dynamic_cast<SliderCtrl*>(ctrl.get())) {
+    if (auto sliderCtrl = std::get_if<SliderCtrl>(ctrl)) {
       sliderCtrl->value = slider->getValue();
-    } else if (auto numberBoxCtrl = dynamic_cast<NumberBoxCtrl*>(ctrl.get())) {
+    } else if (auto numberBoxCtrl = std::get_if<NumberBoxCtrl>(ctrl)) {
       numberBoxCtrl->value = slider->getValue();
     } else {
       DBG("sliderDragEnded: ctrl is not a slider");
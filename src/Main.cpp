@@ -1,4 +1,7 @@
+#include <iostream>
+
 #include "MainComponent.h"
+#include "WatchFolderProcessor.h"
 
 
 //==============================================================================
@@ -28,15 +31,58 @@ public:
             debugFile.appendText(juce::File::getSpecialLocation(juce::File::userHomeDirectory).getFullPathName() + "\n", true, true);
         }
         
+        // headless render-node mode: no window, just a watch-folder pipeline.
+        //   HARP --headless --url <space> --watch <dir> [--output <dir>] [--jobs <n>]
+        if (getCommandLineParameterArray().contains("--headless")) {
+            initialiseHeadless();
+            return;
+        }
+
         mainWindow.reset(new MainWindow(getApplicationName()));
         resetWindow(commandLine);
 
     }
 
+    void initialiseHeadless()
+    {
+        auto args = getCommandLineParameterArray();
+
+        auto valueOf = [&args](const juce::String& flag) -> juce::String {
+            int index = args.indexOf(flag);
+            return (index >= 0 && index + 1 < args.size()) ? args[index + 1] : juce::String();
+        };
+
+        juce::String url = valueOf("--url");
+        juce::File watchDir(valueOf("--watch").unquoted());
+        juce::File outputDir = valueOf("--output").isNotEmpty()
+            ? juce::File(valueOf("--output").unquoted())
+            : watchDir.getChildFile("processed");
+        int jobs = juce::jmax(1, valueOf("--jobs").getIntValue());
+
+        if (url.isEmpty() || !watchDir.isDirectory()) {
+            std::cerr << "usage: HARP --headless --url <space> --watch <dir> [--output <dir>] [--jobs <n>]" << std::endl;
+            setApplicationReturnValue(1);
+            quit();
+            return;
+        }
+
+        std::cout << "HARP headless: processing " << watchDir.getFullPathName()
+                  << " through " << url
+                  << " into " << outputDir.getFullPathName() << std::endl;
+
+        watchProcessor.reset(new WatchFolderProcessor(watchDir, outputDir, url.toStdString(), jobs));
+        watchProcessor->start([this] {
+            std::cerr << "HARP headless: model failed to load, exiting." << std::endl;
+            setApplicationReturnValue(1);
+            quit();
+        });
+    }
+
     void shutdown() override
     {
         // Add your application's shutdown code here..
 
+        watchProcessor = nullptr;
         mainWindow = nullptr; // (deletes our window)
     }
 
@@ -52,7 +98,7 @@ public:
     {
         File inputMediaFile(commandLine.unquoted().trim());
 
-        if (inputMediaFile.existsAsFile()) {
+        if (mainWindow != nullptr && inputMediaFile.existsAsFile()) {
             URL inputMediaURL = URL(inputMediaFile);
             if (auto* mainComp = dynamic_cast<MainComponent*>(mainWindow->getContentComponent())) {
                 mainComp->loadMediaDisplay(inputMediaURL.getLocalFile());
@@ -99,6 +145,12 @@ public:
            #else
             setResizable (true, true);
             centreWithSize (getWidth(), getHeight());
+
+            // put the window back where the last session left it
+            juce::String windowState = SessionSnapshot::savedWindowState();
+            if (windowState.isNotEmpty()) {
+                restoreWindowStateFromString(windowState);
+            }
            #endif
 
             setVisible (true);
@@ -136,6 +188,7 @@ public:
 
 private:
     std::unique_ptr<MainWindow> mainWindow;
+    std::unique_ptr<WatchFolderProcessor> watchProcessor;
 };
 
 //==============================================================================
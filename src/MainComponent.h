@@ -1,5 +1,8 @@
 #pragma once
 
+#include <map>
+#include <optional>
+
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_audio_formats/juce_audio_formats.h>
@@ -13,6 +16,8 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 
 #include "WebModel.h"
+#include "SessionSnapshot.h"
+#include "SpaceWarmupPinger.h"
 #include "CtrlComponent.h"
 #include "TitledTextBox.h"
 #include "ThreadPoolJob.h"
@@ -21,6 +26,7 @@
 #include "gui/StatusComponent.h"
 #include "gui/HoverHandler.h"
 
+#include "media/AudioPlaybackEngine.h"
 #include "media/MediaDisplayComponent.h"
 #include "media/AudioDisplayComponent.h"
 #include "media/MidiDisplayComponent.h"
@@ -441,11 +447,34 @@ public:
         std::map<std::string, std::any> params = {
         {"url", path_url},
         };
+
+        // if this model's card was already prefetched, catch an audio-vs-midi
+        // mismatch with the loaded file right here - before paying for a load
+        // that processCallback would refuse anyway
+        if (mediaDisplay != nullptr && mediaDisplay->isFileLoaded()) {
+            if (auto card = getPrefetchedCard(path_url)) {
+                bool matchingModel = (dynamic_cast<AudioDisplayComponent*>(mediaDisplay.get()) != nullptr)
+                    ? (!card->midi_in && !card->midi_out)
+                    : (card->midi_in && card->midi_out);
+
+                if (!matchingModel) {
+                    DBG("Prefetched card reports model and file type mismatch");
+                    AlertWindow::showMessageBoxAsync(
+                        AlertWindow::WarningIcon,
+                        "Loading Error",
+                        "Model and file type mismatch. Please use an appropriate model or file."
+                    );
+                    resetModelPathComboBox();
+                    return;
+                }
+            }
+        }
+
         resetUI();
         // loading happens asynchronously.
         // the document controller trigger a change listener callback, which will update the UI
 
-        threadPool.addJob([this, params] {
+        jobScheduler.addJob(JobScheduler::Priority::load, [this, params] {
             DBG("executeLoad!!");
             try {
                 // timeout after 10 seconds
@@ -472,6 +501,13 @@ public:
 
                 model->load(params);
                 success = true;
+
+                // remember which model this is for the session snapshot
+                loadedModelPath = std::any_cast<std::string>(params.at("url"));
+
+                // keep the space awake for the rest of the session, so a long
+                // editing pause doesn't put us back on a cold GPU
+                spacePinger.setKeepAliveUrl(resolveSpaceUrl(String(std::any_cast<std::string>(params.at("url")))));
                 MessageManager::callAsync([this] {
                     if (modelPathComboBox.getSelectedItemIndex() == 0) {
                         bool alreadyInComboBox = false;
@@ -499,7 +535,9 @@ public:
                 //Ryan: I commented this out because when the model succesfully loads but you close within 10 seconds it throws a error
             } catch (const std::runtime_error& e) {
                 DBG("Caught exception: " << e.what());
-                
+
+                spacePinger.clearKeepAlive();
+
                 auto msgOpts = MessageBoxOptions().withTitle("Loading Error")
                     .withIconType(AlertWindow::WarningIcon)
                     .withTitle("Error")
@@ -632,8 +670,7 @@ public:
         }
     }
 
-    explicit MainComponent(const URL& initialFilePath = URL()): jobsFinished(0), totalJobs(0),
-        jobProcessorThread(customJobs, jobsFinished, totalJobs, processBroadcaster)
+    explicit MainComponent(const URL& initialFilePath = URL())
     {
 
         addAndMakeVisible(chooseFileButton);
@@ -754,7 +791,9 @@ public:
         // add a status timer to update the status label periodically
         mModelStatusTimer = std::make_unique<ModelStatusTimer>(model);
         mModelStatusTimer->addChangeListener(this);
-        mModelStatusTimer->startTimer(100);  // 100 ms interval
+        // status updates are pushed by the daemon; the timer is just a slow
+        // fallback for the flag-file path, so it doesn't need to be fast
+        mModelStatusTimer->startTimer(500);
 
        // model path textbox
        std::vector<std::string> modelPaths = {
@@ -780,8 +819,49 @@ public:
         for(int i = 0; i < modelPaths.size(); ++i) {
             modelPathComboBox.addItem(modelPaths[i], i + 1);
         }
-        modelPathComboBoxHandler.onMouseEnter = [this]() { 
-            setInstructions("A drop-down menu with some available models. Any new model you add will automatically be added to the list"); 
+        // start waking all the listed spaces in the background, so a sleeping
+        // space has (hopefully) cold-started by the time the user picks it
+        StringArray warmupUrls;
+        for (int i = 1; i < modelPaths.size(); ++i) { // skip "custom path..."
+            warmupUrls.add(resolveSpaceUrl(modelPaths[i]));
+        }
+        spacePinger.warmUpAll(warmupUrls);
+
+        // likewise, open the audio device off the message thread - the
+        // window comes up immediately and the first playback finds the
+        // device already running
+        audioEngine->warmUpAsync();
+
+        // and prefetch every listed model's card, so hovering or picking a
+        // model shows its description and audio/midi type before anything is
+        // loaded. keyed by the combo-box text - the same string load() would
+        // use. priority only orders the pending queue - it can't preempt a
+        // running job, and a cache-miss prefetch holds its worker for a full
+        // one-shot helper spawn - so rather than enqueueing them all at once
+        // (which would occupy every worker and stall a real load behind
+        // warmup work), prefetches run as chains that always leave at least
+        // one worker free.
+        for (int i = 1; i < modelPaths.size(); ++i) {
+            cardPrefetchQueue.add(modelPaths[i]);
+        }
+
+        int prefetchChains = jmax(1, jobScheduler.getNumThreads() - 1);
+        for (int i = 0; i < prefetchChains; ++i) {
+            startNextCardPrefetch();
+        }
+
+        modelPathComboBoxHandler.onMouseEnter = [this]() {
+            // if the selected model's card has already been prefetched,
+            // hovering shows what the model does without loading it
+            if (modelPathComboBox.getSelectedItemIndex() > 0) {
+                if (auto card = getPrefetchedCard(modelPathComboBox.getText().toStdString())) {
+                    String modelType = (card->midi_in && card->midi_out) ? "Midi-to-Midi" : "Wav-to-Wav";
+                    setInstructions(String(card->name) + " (" + modelType + "): " + String(card->description));
+                    return;
+                }
+            }
+
+            setInstructions("A drop-down menu with some available models. Any new model you add will automatically be added to the list");
         };
         modelPathComboBoxHandler.onMouseExit = [this]() { clearInstructions(); };
         modelPathComboBoxHandler.attach();
@@ -839,18 +919,32 @@ public:
         auto &card = model->card();
         setModelCard(card);
 
-        jobProcessorThread.startThread();
-
         // ARA requires that plugin editors are resizable to support tight integration
         // into the host UI
         setOpaque (true);
         setSize(800, 800);
         resized();
+
+        // pick up where the last session left off: media + undo chain come
+        // back instantly, and the model reloads through the control-spec
+        // cache with its saved control values
+        restoreSessionSnapshot();
+
+        // keep the snapshot fresh in the background. writes only happen
+        // when something actually changed, and go through the batch queue
+        // so the message thread never touches the disk for this.
+        sessionSnapshotTimer.onTick = [this] { captureSessionSnapshot(); };
+        sessionSnapshotTimer.startTimer(15000);
     }
 
 
     ~MainComponent() override
     {
+        // one last snapshot, written in place since the scheduler is about
+        // to drain
+        sessionSnapshotTimer.stopTimer();
+        captureSessionSnapshot(true);
+
         mediaDisplay->removeChangeListener(this);
 
         // remove listeners
@@ -858,12 +952,17 @@ public:
         loadBroadcaster.removeChangeListener(this);
         processBroadcaster.removeChangeListener(this);
 
-        jobProcessorThread.signalThreadShouldExit();
-        // This will not actually run any processing task
-        // It'll just make sure that the thread is not waiting
-        // and it'll allow it to check for the threadShouldExit flag
-        jobProcessorThread.signalTask();
-        jobProcessorThread.waitForThreadToExit(-1);
+        // drop anything still queued and wait for running jobs, so a
+        // completion callback can't fire into a destroyed broadcaster
+        jobScheduler.shutdown();
+
+        // dump where this session's time went: a per-stage summary in the
+        // debug log, and a chrome-trace file for the trace viewer
+        DBG(Tracer::get().summary());
+        Tracer::get().exportChromeTrace(
+            File::getSpecialLocation(File::userApplicationDataDirectory)
+                .getChildFile("HARP").getChildFile("traces")
+                .getChildFile("session_" + String(Time::currentTimeMillis()) + ".json"));
 
         #if JUCE_MAC
             MenuBarModel::setMacMainMenu (nullptr);
@@ -874,7 +973,17 @@ public:
     void cancelCallback()
     {
         DBG("HARPProcessorEditor::buttonClicked cancel button listener activated");
+
+        // skip the job if it hasn't been picked up yet; if it's already
+        // running, the model cancel below stops it at the source
+        JobScheduler::cancel(processCancelToken);
         model->cancel();
+
+        // cancelling also abandons any queued batch files
+        processingQueue.clear();
+        batchTotal = 0;
+        batchCompleted = 0;
+
         // We already added a temp file, so we need to undo that
         mediaDisplay->iteratePreviousTempFile();
         mediaDisplay->clearFutureTempFiles();
@@ -883,6 +992,8 @@ public:
     
     void processCallback()
     {
+        HARP_TRACE("ui.process_callback");
+
         DBG("HARPProcessorEditor::buttonClicked button listener activated");
 
         // check if the audio file is loaded
@@ -932,31 +1043,65 @@ public:
             );
             // processBroadcaster.sendChangeMessage();
             resetProcessingButtons();
+
+            // a mismatched file shouldn't stall the rest of a batch
+            processingQueue.clear();
+            batchTotal = 0;
+            batchCompleted = 0;
             return;
         }
 
+        // starting a fresh (possibly single-file) batch
+        if (batchTotal == 0) {
+            batchTotal = 1 + processingQueue.size();
+            batchCompleted = 0;
+        }
+
         mediaDisplay->addNewTempFile();
 
-        // print how many jobs are currently in the threadpool
-        DBG("threadPool.getNumJobs: " << threadPool.getNumJobs());
+        // print how many jobs are currently waiting in the scheduler
+        DBG("jobScheduler.getNumJobs: " << jobScheduler.getNumJobs());
+
+        // the file the user clicked process on is interactive; anything it
+        // queued behind itself is batch work a concurrent load may overtake
+        auto priority = (batchCompleted > 0) ? JobScheduler::Priority::batch
+                                             : JobScheduler::Priority::interactive;
+
+        processCancelToken = jobScheduler.addJob(
+            priority,
+            [this] {
+                try {
+                    // copy the audio file, with the same filename except for an added _harp to the stem
+                    model->process(mediaDisplay->getTempFilePath().getLocalFile());
+                    DBG("Processing finished");
+
+                    // load the audio file again
+                    processBroadcaster.sendChangeMessage();
+                } catch (const std::runtime_error& e) {
+                    // we're on a pool worker here: anything that escapes
+                    // terminates the app, so surface it and unwind instead
+                    DBG("Caught exception: " << e.what());
 
-        // empty customJobs
-        customJobs.clear();
+                    AlertWindow::showMessageBoxAsync(
+                        AlertWindow::WarningIcon,
+                        "Processing Error",
+                        "An error occurred while processing the file: \n" + String(e.what())
+                    );
 
-        customJobs.push_back(new CustomThreadPoolJob(
-            [this] { // &jobsFinished, totalJobs
-                // Individual job code for each iteration
-                // copy the audio file, with the same filename except for an added _harp to the stem
-                model->process(mediaDisplay->getTempFilePath().getLocalFile());
-                DBG("Processing finished");
-                // load the audio file again
-                processBroadcaster.sendChangeMessage();
-                
+                    MessageManager::callAsync([this] {
+                        // undo the temp file added for this job and abandon the
+                        // rest of the batch - same unwinding as cancelCallback
+                        processingQueue.clear();
+                        batchTotal = 0;
+                        batchCompleted = 0;
+
+                        mediaDisplay->iteratePreviousTempFile();
+                        mediaDisplay->clearFutureTempFiles();
+                        resetProcessingButtons();
+                    });
+                }
             }
-        ));
-
-        // Now the customJobs are ready to be added to be run in the threadPool
-        jobProcessorThread.signalTask();
+        );
     }
 
     void initializeMediaDisplay(int mediaType = 0)
@@ -1254,9 +1399,190 @@ private:
     // the model itself
     std::shared_ptr<WebModel> model {new WebModel()};
 
+    // wakes sleeping spaces ahead of time and keeps the loaded one warm
+    SpaceWarmupPinger spacePinger;
+
+    // model cards prefetched in the background for the combo-box entries,
+    // keyed by the combo-box text (the same string load() uses)
+    std::map<std::string, ModelCard> prefetchedCards;
+    CriticalSection prefetchedCardsLock;
+
+    std::optional<ModelCard> getPrefetchedCard(const std::string& url)
+    {
+        const ScopedLock lock(prefetchedCardsLock);
+
+        auto it = prefetchedCards.find(url);
+        if (it != prefetchedCards.end()) {
+            return it->second;
+        }
+
+        return std::nullopt;
+    }
+
+    // combo-box entries whose cards still need prefetching, guarded by
+    // prefetchedCardsLock along with the cache itself
+    StringArray cardPrefetchQueue;
+
+    // pops one entry off the prefetch queue and fetches its card at batch
+    // priority; each fetch schedules the next, so the number of chains
+    // started in the constructor bounds how many workers prefetching can
+    // ever occupy at once.
+    void startNextCardPrefetch()
+    {
+        std::string cardUrl;
+
+        {
+            const ScopedLock lock(prefetchedCardsLock);
+
+            if (cardPrefetchQueue.isEmpty()) {
+                return;
+            }
+
+            cardUrl = cardPrefetchQueue[0].toStdString();
+            cardPrefetchQueue.remove(0);
+        }
+
+        jobScheduler.addJob(JobScheduler::Priority::batch, [this, cardUrl] {
+            if (auto card = WebModel::fetchCardForUrl(cardUrl)) {
+                const ScopedLock lock(prefetchedCardsLock);
+                prefetchedCards[cardUrl] = *card;
+            }
+
+            startNextCardPrefetch();
+        });
+    }
+
+    // ---- session snapshot ----
+
+    // the combo-box string the currently loaded model came from
+    std::string loadedModelPath;
+
+    // control values read from a snapshot, waiting for the model load they
+    // belong to to finish
+    var pendingRestoredCtrlValues;
+
+    // the last JSON actually written, so an unchanged session costs nothing
+    String lastSnapshotJson;
+
+    struct SnapshotTimer : public Timer {
+        std::function<void()> onTick;
+        void timerCallback() override { if (onTick) onTick(); }
+    } sessionSnapshotTimer;
+
+    void captureSessionSnapshot(bool synchronous = false)
+    {
+        SessionSnapshot snapshot;
+
+        snapshot.modelUrl = loadedModelPath;
+
+        if (model != nullptr && model->ready()) {
+            snapshot.ctrlValues = model->getCtrlValues();
+        }
+
+        if (mediaDisplay != nullptr && mediaDisplay->isFileLoaded()) {
+            snapshot.targetFilePath = mediaDisplay->getTargetFilePath().toString(false);
+
+            for (const auto& path : mediaDisplay->getTempFilePaths()) {
+                snapshot.tempFilePaths.add(path.toString(false));
+            }
+
+            snapshot.currentTempFileIdx = mediaDisplay->getCurrentTempFileIdx();
+        }
+
+        if (auto* window = dynamic_cast<ResizableWindow*>(getTopLevelComponent())) {
+            snapshot.windowState = window->getWindowStateAsString();
+        }
+
+        String json = snapshot.toJson();
+
+        if (json == lastSnapshotJson) {
+            return;
+        }
+        lastSnapshotJson = json;
+
+        if (synchronous) {
+            snapshot.writeToFile();
+        } else {
+            jobScheduler.addJob(JobScheduler::Priority::batch, [snapshot] {
+                snapshot.writeToFile();
+            });
+        }
+    }
+
+    void restoreSessionSnapshot()
+    {
+        auto snapshot = SessionSnapshot::readFromFile();
+
+        if (!snapshot) {
+            return;
+        }
+
+        // media + undo chain first, so a restored model finds a file loaded
+        if (snapshot->currentTempFileIdx >= 0 && !snapshot->tempFilePaths.isEmpty()) {
+            Array<URL> chain;
+
+            for (const auto& path : snapshot->tempFilePaths) {
+                chain.add(URL(path));
+            }
+
+            URL targetPath(snapshot->targetFilePath);
+            String extension = targetPath.getLocalFile().getFileExtension();
+
+            // swap in the matching display type before restoring into it
+            bool matchingDisplay = (dynamic_cast<AudioDisplayComponent*>(mediaDisplay.get()) != nullptr)
+                ? audioExtensions.contains(extension)
+                : midiExtensions.contains(extension);
+
+            if (!matchingDisplay) {
+                removeChildComponent(mediaDisplay.get());
+                mediaDisplay->removeChangeListener(this);
+                mediaDisplayHandler->detach();
+
+                initializeMediaDisplay(midiExtensions.contains(extension) ? 1 : 0);
+            }
+
+            if (mediaDisplay->restoreMediaState(targetPath, chain, snapshot->currentTempFileIdx)) {
+                DBG("Restored media session for " << targetPath.getLocalFile().getFullPathName());
+
+                lastLoadTime = Time::getCurrentTime();
+                playStopButton.setEnabled(true);
+                resized();
+            }
+        }
+
+        // then the model: select its entry (adding it if it isn't listed)
+        // and run the normal load path - the cached control spec makes this
+        // come up in about a second, after which the saved values go back in
+        if (!snapshot->modelUrl.empty()) {
+            pendingRestoredCtrlValues = snapshot->ctrlValues;
+
+            int itemId = -1;
+
+            for (int i = 1; i < modelPathComboBox.getNumItems(); ++i) { // skip "custom path..."
+                if (modelPathComboBox.getItemText(i).toStdString() == snapshot->modelUrl) {
+                    itemId = i + 1;
+                    break;
+                }
+            }
+
+            if (itemId < 0) {
+                modelPathComboBox.addItem(snapshot->modelUrl, modelPathComboBox.getNumItems() + 1);
+                itemId = modelPathComboBox.getNumItems();
+            }
+
+            modelPathComboBox.setSelectedId(itemId, dontSendNotification);
+            loadModelCallback();
+        }
+    }
+
     std::unique_ptr<FileChooser> openFileBrowser;
     std::unique_ptr<FileChooser> saveFileBrowser;
 
+    // pins the shared playback engine for the whole session, so swapping
+    // display components never tears the audio device down and back up.
+    // declared before mediaDisplay so it outlives the displays that use it.
+    SharedResourcePointer<AudioPlaybackEngine> audioEngine;
+
     std::unique_ptr<MediaDisplayComponent> mediaDisplay;
 
     std::unique_ptr<HoverHandler> mediaDisplayHandler;
@@ -1264,15 +1590,15 @@ private:
     StringArray audioExtensions = AudioDisplayComponent::getSupportedExtensions();
     StringArray midiExtensions = MidiDisplayComponent::getSupportedExtensions();
 
-    /// CustomThreadPoolJob
-    // This one is used for Loading the models
-    // The thread pull for Processing lives inside the JobProcessorThread
-    ThreadPool threadPool {1};
-    int jobsFinished;
-    int totalJobs;
-    JobProcessorThread jobProcessorThread;
-    std::vector<CustomThreadPoolJob*> customJobs;
-    
+    // one shared scheduler for load and process jobs
+    JobScheduler jobScheduler;
+    JobScheduler::CancellationToken processCancelToken;
+
+    // files waiting behind the currently loaded one in a batch run
+    Array<File> processingQueue;
+    int batchTotal = 0;
+    int batchCompleted = 0;
+
     ChangeBroadcaster loadBroadcaster;
     ChangeBroadcaster processBroadcaster;
 
@@ -1312,12 +1638,21 @@ private:
     {
         if (source == mediaDisplay.get()) {
             if (mediaDisplay->isFileDropped()) {
-                URL droppedFilePath = mediaDisplay->getDroppedFilePath();
+                Array<URL> droppedFilePaths = mediaDisplay->getDroppedFilePaths();
 
                 mediaDisplay->clearDroppedFile();
 
-                // Reload an appropriate display for dropped file
-                loadMediaDisplay(droppedFilePath.getLocalFile());
+                // Reload an appropriate display for the first dropped file;
+                // any additional files join the batch queue
+                loadMediaDisplay(droppedFilePaths.getReference(0).getLocalFile());
+
+                for (int i = 1; i < droppedFilePaths.size(); ++i) {
+                    processingQueue.add(droppedFilePaths.getReference(i).getLocalFile());
+                }
+
+                if (!processingQueue.isEmpty()) {
+                    setStatus(String(processingQueue.size()) + " more file(s) queued. Click Process to run the batch.");
+                }
             } else if (mediaDisplay->isFileLoaded() && !mediaDisplay->isPlaying()) {
                 playStopButton.setMode(playButtonInfo.label);
                 playStopButton.setEnabled(true);
@@ -1332,6 +1667,14 @@ private:
             DBG("Setting up model card, CtrlComponent, resizing.");
             setModelCard(model->card());
             ctrlComponent.setModel(model);
+
+            // a session restore re-applies its saved control values once the
+            // fresh spec is in, before the widgets read them
+            if (!pendingRestoredCtrlValues.isVoid()) {
+                model->setCtrlValues(pendingRestoredCtrlValues);
+                pendingRestoredCtrlValues = var();
+            }
+
             ctrlComponent.populateGui();
             repaint();
 
@@ -1348,15 +1691,51 @@ private:
             // Set the focus to the process button
             // so that the user can press SPACE to trigger the playback
             processCancelButton.grabKeyboardFocus();
+
+            // watch for partial outputs pushed while a job runs
+            // (duplicate adds are ignored, so re-loading is harmless)
+            model->partialBroadcaster().addChangeListener(this);
+
             resized();
         }
+        else if (source == &model->partialBroadcaster()) {
+            // a completed prefix of the output landed - show it while the
+            // rest is still generating, unless the user is mid-playback
+            File partialFile = model->getPartialOutputFile();
+
+            if (partialFile.existsAsFile() && !mediaDisplay->isPlaying()) {
+                mediaDisplay->updateDisplay(URL(partialFile));
+                setStatus("Showing partial result while processing continues...");
+            }
+        }
         else if (source == &processBroadcaster) {
             // refresh the display for the new updated file
             URL tempFilePath = mediaDisplay->getTempFilePath();
             mediaDisplay->updateDisplay(tempFilePath);
 
-            // now, we can enable the process button
-            resetProcessingButtons();
+            batchCompleted++;
+
+            if (!processingQueue.isEmpty()) {
+                // keep the batch rolling: load the next queued file and
+                // immediately send it off for processing
+                File nextFile = processingQueue.removeAndReturn(0);
+
+                setStatus("Processed " + String(batchCompleted) + " of " + String(batchTotal) + " files");
+                loadMediaDisplay(nextFile);
+
+                isProcessing = false;
+                processCallback();
+            } else {
+                if (batchTotal > 1) {
+                    setStatus("Batch complete: processed " + String(batchCompleted) + " of " + String(batchTotal) + " files");
+                }
+
+                batchTotal = 0;
+                batchCompleted = 0;
+
+                // now, we can enable the process button
+                resetProcessingButtons();
+            }
         }
         else if (source == mModelStatusTimer.get()) {
             // update the status label
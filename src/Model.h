@@ -34,6 +34,20 @@ struct ModelCard {
   std::vector<std::string> tags;
   bool midi_in;
   bool midi_out;
+  // window length (in seconds) for models that opt into chunked streaming;
+  // 0 means the whole file is processed as one blob
+  double chunk_duration {0.0};
+  // additional endpoints running the same model (self-hosted replicas or
+  // duplicated spaces). chunked jobs fan windows out across them concurrently.
+  std::vector<std::string> replica_urls;
+  // audio uploads/downloads are transcoded to FLAC to halve WAN transfer
+  // bytes. opt-in with "flac_transfer": true - only cards whose space
+  // actually returns the format it was sent should enable it
+  bool flac_transfer {false};
+  // models that resample to a fixed rate server-side anyway can declare it
+  // so the upload is resampled (and shrunk further) client-side; 0 = keep
+  // the input rate
+  double native_sample_rate {0.0};
 };
 
 
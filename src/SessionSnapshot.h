@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @brief Session state snapshot: the loaded model, its control values, the
+ * open media file with its undo chain, and the window placement, persisted
+ * as a small JSON file so a restart (or a crash) resumes to a working state
+ * instead of starting from scratch.
+ * @author hugo flores garcia, aldo aguilar
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "juce_core/juce_core.h"
+
+
+struct SessionSnapshot {
+  std::string modelUrl;          // the combo-box string load() was given
+  juce::var ctrlValues;          // per-control values, in ctrl-list order
+  juce::String targetFilePath;   // URL string of the media target
+  juce::StringArray tempFilePaths; // the undo chain, as URL strings
+  int currentTempFileIdx = -1;
+  juce::String windowState;      // ResizableWindow::getWindowStateAsString()
+
+  static juce::File snapshotFile() {
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("HARP").getChildFile("session.json");
+  }
+
+  juce::String toJson() const {
+    juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+
+    obj->setProperty("model_url", juce::String(modelUrl));
+    obj->setProperty("ctrl_values", ctrlValues);
+    obj->setProperty("target_file", targetFilePath);
+
+    juce::Array<juce::var> chain;
+    for (const auto& path : tempFilePaths) {
+      chain.add(path);
+    }
+    obj->setProperty("temp_files", chain);
+
+    obj->setProperty("current_temp_file_idx", currentTempFileIdx);
+    obj->setProperty("window_state", windowState);
+
+    return juce::JSON::toString(juce::var(obj.get()), true);
+  }
+
+  // stage + rename, so a crash mid-write can't leave a torn snapshot behind
+  bool writeToFile() const {
+    juce::File file = snapshotFile();
+    file.getParentDirectory().createDirectory();
+
+    juce::File staging = file.getSiblingFile(file.getFileName() + ".tmp");
+    staging.deleteFile();
+
+    if (!staging.replaceWithText(toJson())) {
+      return false;
+    }
+
+    return staging.moveFileTo(file);
+  }
+
+  static std::optional<SessionSnapshot> readFromFile() {
+    juce::File file = snapshotFile();
+
+    if (!file.existsAsFile()) {
+      return std::nullopt;
+    }
+
+    juce::var parsed = juce::JSON::parse(file.loadFileAsString());
+    juce::DynamicObject* obj = parsed.getDynamicObject();
+
+    if (obj == nullptr) {
+      return std::nullopt;
+    }
+
+    SessionSnapshot snapshot;
+    snapshot.modelUrl = obj->getProperty("model_url").toString().toStdString();
+    snapshot.ctrlValues = obj->getProperty("ctrl_values");
+    snapshot.targetFilePath = obj->getProperty("target_file").toString();
+
+    if (auto* chain = obj->getProperty("temp_files").getArray()) {
+      for (const auto& path : *chain) {
+        snapshot.tempFilePaths.add(path.toString());
+      }
+    }
+
+    snapshot.currentTempFileIdx = obj->hasProperty("current_temp_file_idx")
+        ? (int) obj->getProperty("current_temp_file_idx") : -1;
+    snapshot.windowState = obj->getProperty("window_state").toString();
+
+    return snapshot;
+  }
+
+  // just the window placement - read by MainWindow before MainComponent has
+  // restored anything else
+  static juce::String savedWindowState() {
+    if (auto snapshot = readFromFile()) {
+      return snapshot->windowState;
+    }
+
+    return {};
+  }
+};
@@ -0,0 +1,81 @@
+/**
+ * @file
+ * @brief Wakes sleeping Hugging Face spaces before they're needed, and keeps
+ * the loaded model's space awake for the rest of the session. Spaces pause
+ * after a period of inactivity and eat a multi-minute cold start on the next
+ * request, which is where most of our load/process timeouts come from.
+ */
+
+#pragma once
+
+#include "juce_core/juce_core.h"
+#include "juce_events/juce_events.h"
+
+
+class SpaceWarmupPinger : private juce::Timer {
+public:
+  SpaceWarmupPinger() { startTimer(keepAliveIntervalMs); }
+
+  ~SpaceWarmupPinger() override { stopTimer(); }
+
+  //! fire-and-forget wake-up requests for all the given space urls.
+  //! pings run sequentially on one background thread so startup doesn't
+  //! open a dozen sockets at once.
+  void warmUpAll(juce::StringArray spaceUrls) {
+    juce::Thread::launch([spaceUrls] {
+      for (const auto& url : spaceUrls) {
+        ping(url);
+      }
+    });
+  }
+
+  //! keep this space's inactivity clock from ever running out while a
+  //! model is loaded
+  void setKeepAliveUrl(const juce::String& spaceUrl) {
+    const juce::ScopedLock lock(urlLock);
+    keepAliveUrl = spaceUrl;
+  }
+
+  void clearKeepAlive() {
+    const juce::ScopedLock lock(urlLock);
+    keepAliveUrl = {};
+  }
+
+private:
+  void timerCallback() override {
+    juce::String url;
+    {
+      const juce::ScopedLock lock(urlLock);
+      url = keepAliveUrl;
+    }
+
+    if (url.isNotEmpty()) {
+      // never block the message thread on the network
+      juce::Thread::launch([url] { ping(url); });
+    }
+  }
+
+  //! a GET against the space landing page is enough to start (or reset) its
+  //! inactivity clock; we only read a token of the response
+  static void ping(const juce::String& spaceUrl) {
+    juce::URL url(spaceUrl);
+
+    auto stream = url.createInputStream(
+        juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inAddress)
+            .withConnectionTimeoutMs(10000));
+
+    if (stream != nullptr) {
+      char buffer[64];
+      stream->read(buffer, sizeof(buffer));
+      DBG("SpaceWarmupPinger::ping: pinged " << spaceUrl);
+    } else {
+      DBG("SpaceWarmupPinger::ping: failed to reach " << spaceUrl);
+    }
+  }
+
+  // spaces sleep after roughly an hour idle; every few minutes is plenty
+  static constexpr int keepAliveIntervalMs = 4 * 60 * 1000;
+
+  juce::CriticalSection urlLock;
+  juce::String keepAliveUrl;
+};
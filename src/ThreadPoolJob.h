@@ -1,3 +1,12 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <vector>
+
 #include "juce_core/juce_core.h"
 #include "juce_events/juce_events.h"
 using namespace juce;
@@ -22,72 +31,126 @@ class CustomThreadPoolJob : public ThreadPoolJob {
     std::function<void()> jobFunction;
 };
 
-class JobProcessorThread : public Thread {
+// One scheduler for everything HARP runs off the message thread. Load and
+// process jobs share a single small pool, a free worker always picks the
+// most urgent pending job, and completion is reported through a callback
+// instead of a thread blocking in waitForJobToFinish().
+class JobScheduler {
   public:
-    JobProcessorThread(const std::vector<CustomThreadPoolJob*>& jobs,
-                        int& _jobsFinished,
-                        int& _totalJobs,
-                        ChangeBroadcaster& broadcaster
-                    )
-        : Thread("JobProcessorThread"),
-        customJobs(jobs),
-        jobsFinished(jobsFinished),
-        totalJobs(totalJobs),
-        processBroadcaster(broadcaster)
+    enum class Priority {
+      load = 0,        // the user is blocked on the model controls appearing
+      interactive = 1, // a process the user just clicked
+      batch = 2        // queued files behind the current one
+    };
+
+    // shared flag a canceller can fire. a job cancelled before it starts is
+    // skipped entirely, completion callback included; a job already running
+    // has to be stopped at the source, e.g. WebModel::cancel().
+    using CancellationToken = std::shared_ptr<std::atomic<bool>>;
+
+    JobScheduler(int numThreads = jlimit(2, 4, SystemStats::getNumCpus()))
+        : pool(numThreads)
     {}
 
-    ~JobProcessorThread() override {
-      // threadPool.removeAllJobs(true, 1000);
+    ~JobScheduler() {
+      shutdown();
     }
 
-    // void initiateJobs() {}
-    void run() override {
-      while (!threadShouldExit()) {
-        // Wait for a signal to execute a task
-        signalEvent.wait(-1);
+    // schedules jobFunction at the given priority. onDone runs on the worker
+    // thread once the job returns; it does NOT run for a job skipped after
+    // cancellation, so the cancel path and the completion path can never
+    // both fire for the same job. use a ChangeBroadcaster or
+    // MessageManager::callAsync inside it to get back to the message thread.
+    CancellationToken addJob(Priority priority,
+                             std::function<void()> jobFunction,
+                             std::function<void()> onDone = nullptr) {
+      auto token = std::make_shared<std::atomic<bool>>(false);
 
-        // Check if the thread should exit before executing the task
-        if (threadShouldExit()){
-          DBG("Thread should exit");
-          break;
-        }
-        // Execute your task here
-        executeTask();
+      {
+        const ScopedLock lock(queueLock);
+        pending.push_back({priority, nextSequence++, std::move(jobFunction), std::move(onDone), token});
+      }
+
+      // one runner per entry - the runner itself decides which pending job
+      // is the most urgent at the moment a worker picks it up
+      pool.addJob(new CustomThreadPoolJob([this] { runNextPending(); }), true);
+
+      return token;
+    }
+
+    static void cancel(const CancellationToken& token) {
+      if (token != nullptr) {
+        *token = true;
       }
     }
 
-    void signalTask() {
-      // Send a signal to wake up the thread and execute a task
-      signalEvent.signal();
+    int getNumJobs() {
+      return pool.getNumJobs();
+    }
+
+    // pool width - callers throttling background work against it (e.g. the
+    // card prefetch chains) can size themselves to always leave a worker free
+    int getNumThreads() const {
+      return pool.getNumThreads();
+    }
+
+    // drops everything still queued and waits for running jobs to return.
+    // called from the MainComponent destructor before the broadcasters the
+    // completion callbacks talk to go away.
+    void shutdown() {
+      {
+        const ScopedLock lock(queueLock);
+        pending.clear();
+      }
+
+      pool.removeAllJobs(true, 10000);
     }
 
   private:
+    struct PendingJob {
+      Priority priority;
+      uint64 sequence; // keeps FIFO order within a priority class
+      std::function<void()> run;
+      std::function<void()> onDone;
+      CancellationToken token;
+    };
 
-    void executeTask() {
-      for (auto& customJob : customJobs) {
-            threadPool.addJob(customJob, true); // The pool will take ownership and delete the job when finished
-            // customJob->runJob();
-        }
+    void runNextPending() {
+      PendingJob job;
+
+      {
+        const ScopedLock lock(queueLock);
 
-        // Wait for all jobs to finish
-        for (auto& customJob : customJobs) {
-            threadPool.waitForJobToFinish(customJob, -1); // -1 for no timeout
+        if (pending.empty()) {
+          return;
         }
 
-        // This will run after all jobs are done
-        // if (jobsFinished == totalJobs) {
-        processBroadcaster.sendChangeMessage();
-        // }
+        auto mostUrgent = std::min_element(pending.begin(), pending.end(),
+            [](const PendingJob& a, const PendingJob& b) {
+              return std::tie(a.priority, a.sequence) < std::tie(b.priority, b.sequence);
+            });
+
+        job = std::move(*mostUrgent);
+        pending.erase(mostUrgent);
+      }
+
+      const bool skipped = (job.token != nullptr && *job.token);
+
+      if (job.run && !skipped) {
+        job.run();
+      }
+
+      // a skipped job must not report completion: by the time the flag was
+      // fired, the cancel path already unwound whatever state the completion
+      // callback would act on
+      if (job.onDone && !skipped) {
+        job.onDone();
+      }
     }
 
-    const std::vector<CustomThreadPoolJob*>& customJobs;
-
-     // HUGO: these are unused. What are they for?
-    int& jobsFinished;
-    int& totalJobs;
-    
-    // ThreadPool for processing jobs (not loading)
-    ThreadPool threadPool {10};
-    ChangeBroadcaster& processBroadcaster;
-    WaitableEvent signalEvent;
-};
\ No newline at end of file
+    CriticalSection queueLock;
+    std::vector<PendingJob> pending;
+    uint64 nextSequence = 0;
+
+    ThreadPool pool;
+};
@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @brief Lightweight scoped-timer instrumentation for the hot paths. Each
+ * HARP_TRACE records one span into a process-wide tracer that keeps
+ * per-stage aggregates (count/total/min/max) plus a bounded raw event list
+ * that can be exported in chrome trace format (open it in a trace viewer,
+ * e.g. chrome://tracing or Perfetto, to see where a session's time went).
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "juce_core/juce_core.h"
+
+
+class Tracer {
+public:
+  static Tracer& get() {
+    static Tracer instance;
+    return instance;
+  }
+
+  //! records one completed span. called from whatever thread ran the work.
+  void record(const juce::String& name, juce::int64 startTicks, juce::int64 endTicks) {
+    double startUs = juce::Time::highResolutionTicksToSeconds(startTicks) * 1.0e6;
+    double durUs = juce::Time::highResolutionTicksToSeconds(endTicks - startTicks) * 1.0e6;
+    double durMs = durUs / 1000.0;
+
+    const juce::ScopedLock lock(m_lock);
+
+    auto& stage = m_stages[name];
+    if (stage.count == 0) {
+      stage.minMs = durMs;
+      stage.maxMs = durMs;
+    } else {
+      stage.minMs = juce::jmin(stage.minMs, durMs);
+      stage.maxMs = juce::jmax(stage.maxMs, durMs);
+    }
+    stage.count++;
+    stage.totalMs += durMs;
+
+    // the aggregates above are unbounded; the raw event list is capped so a
+    // very long session can't eat memory
+    if (m_events.size() < maxEvents) {
+      m_events.push_back({name, startUs, durUs, juce::Thread::getCurrentThreadId()});
+    }
+  }
+
+  //! one line per stage, for dropping into the log at shutdown
+  juce::String summary() const {
+    const juce::ScopedLock lock(m_lock);
+
+    juce::String out = "trace summary (ms):\n";
+
+    for (const auto& [name, stage] : m_stages) {
+      out << "  " << name
+          << ": n=" << juce::String(stage.count)
+          << " total=" << juce::String(stage.totalMs, 1)
+          << " mean=" << juce::String(stage.totalMs / (double) stage.count, 1)
+          << " min=" << juce::String(stage.minMs, 1)
+          << " max=" << juce::String(stage.maxMs, 1) << "\n";
+    }
+
+    return out;
+  }
+
+  //! writes the raw spans as a chrome-trace-format JSON file
+  bool exportChromeTrace(const juce::File& outFile) const {
+    juce::var traceEvents;
+
+    {
+      const juce::ScopedLock lock(m_lock);
+
+      for (const auto& event : m_events) {
+        juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+        obj->setProperty("name", event.name);
+        obj->setProperty("ph", "X");
+        obj->setProperty("ts", event.startUs);
+        obj->setProperty("dur", event.durUs);
+        obj->setProperty("pid", 1);
+        obj->setProperty("tid", juce::String::toHexString((juce::pointer_sized_int) event.threadId));
+        traceEvents.append(juce::var(obj.get()));
+      }
+    }
+
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    root->setProperty("traceEvents", traceEvents);
+
+    outFile.getParentDirectory().createDirectory();
+    return outFile.replaceWithText(juce::JSON::toString(juce::var(root.get())));
+  }
+
+private:
+  Tracer() = default;
+
+  struct Stage {
+    juce::int64 count {0};
+    double totalMs {0.0};
+    double minMs {0.0};
+    double maxMs {0.0};
+  };
+
+  struct Event {
+    juce::String name;
+    double startUs;
+    double durUs;
+    juce::Thread::ThreadID threadId;
+  };
+
+  static constexpr size_t maxEvents = 100000;
+
+  mutable juce::CriticalSection m_lock;
+  std::map<juce::String, Stage> m_stages;
+  std::vector<Event> m_events;
+};
+
+
+//! times the enclosing scope and reports it to the Tracer on exit
+class ScopedTrace {
+public:
+  ScopedTrace(const char* name)
+      : m_name(name), m_start(juce::Time::getHighResolutionTicks()) {}
+
+  ~ScopedTrace() {
+    Tracer::get().record(m_name, m_start, juce::Time::getHighResolutionTicks());
+  }
+
+private:
+  juce::String m_name;
+  juce::int64 m_start;
+};
+
+#define HARP_TRACE_CONCAT2(a, b) a##b
+#define HARP_TRACE_CONCAT(a, b) HARP_TRACE_CONCAT2(a, b)
+#define HARP_TRACE(name) ScopedTrace HARP_TRACE_CONCAT(harpScopedTrace, __LINE__)(name)
@@ -0,0 +1,210 @@
+/**
+ * @file
+ * @brief Watch-folder pipeline: every media file dropped into a directory is
+ * processed through a web model and written to an output directory. Drives
+ * the --headless render-node mode in Main.cpp, but is plain enough for the
+ * GUI to host one too.
+ * @author hugo flores garcia, aldo aguilar
+ */
+
+#pragma once
+
+#include <set>
+
+#include "ThreadPoolJob.h"
+#include "WebModel.h"
+
+#include "juce_core/juce_core.h"
+#include "juce_events/juce_events.h"
+
+
+// Polls a watch directory (JUCE has no portable filesystem-event API, so a
+// low-frequency timer scan stands in for one), queues every file that has
+// stopped growing, and fans them through the model on the batch scheduler
+// with a bounded number in flight. Completed inputs go into a journal file
+// in the output directory, so a crash or restart resumes where it left off
+// instead of re-processing the whole folder.
+class WatchFolderProcessor : private juce::Timer {
+public:
+
+  WatchFolderProcessor(juce::File watchDirectory, juce::File outputDirectory,
+                       std::string modelUrl, int maxJobsInFlight = 1)
+      : m_watchDir(watchDirectory),
+        m_outputDir(outputDirectory),
+        m_modelUrl(std::move(modelUrl)),
+        m_maxInFlight(juce::jmax(1, maxJobsInFlight)),
+        m_scheduler(juce::jmax(1, maxJobsInFlight)) {
+    m_outputDir.createDirectory();
+  }
+
+  ~WatchFolderProcessor() override {
+    stopTimer();
+    m_scheduler.shutdown();
+  }
+
+  // loads the model in the background and starts scanning once it's up.
+  // onFatalError fires (on the message thread) if the load fails.
+  void start(std::function<void()> onFatalError = nullptr) {
+    readJournal();
+
+    m_scheduler.addJob(JobScheduler::Priority::load, [this, onFatalError] {
+      try {
+        std::map<std::string, std::any> params = { {"url", m_modelUrl} };
+        m_model->load(params);
+
+        juce::MessageManager::callAsync([this] {
+          DBG("Watch-folder: model loaded, watching " + m_watchDir.getFullPathName());
+          startTimer(pollIntervalMs);
+        });
+      } catch (const std::exception& e) {
+        DBG("Watch-folder: failed to load model: " + juce::String(e.what()));
+
+        if (onFatalError != nullptr) {
+          juce::MessageManager::callAsync(onFatalError);
+        }
+      }
+    });
+  }
+
+  int numProcessed() const { return m_numProcessed.load(); }
+
+private:
+
+  static constexpr int pollIntervalMs = 2000;
+
+  void timerCallback() override {
+    for (const auto& entry : juce::RangedDirectoryIterator(m_watchDir, false, "*", juce::File::findFiles)) {
+      juce::File file = entry.getFile();
+
+      if (!isSupportedMediaFile(file)) {
+        continue;
+      }
+
+      // a file is only taken once its size has held still for a full poll
+      // interval - half-copied drops would fail in the helper otherwise
+      juce::int64 size = file.getSize();
+      auto lastSeen = m_lastSeenSizes.find(file.getFullPathName());
+
+      if (lastSeen == m_lastSeenSizes.end() || lastSeen->second != size || size == 0) {
+        m_lastSeenSizes[file.getFullPathName()] = size;
+        continue;
+      }
+
+      juce::String key = journalKeyFor(file);
+
+      if (m_completed.count(key) || m_inProgress.count(key) || m_failed.count(key)) {
+        continue;
+      }
+
+      // bounded depth: anything past the in-flight cap stays on disk and is
+      // picked up by a later scan
+      if ((int) m_inProgress.size() >= m_maxInFlight) {
+        return;
+      }
+
+      m_inProgress.insert(key);
+
+      m_scheduler.addJob(JobScheduler::Priority::batch, [this, file, key] {
+        processOne(file, key);
+      });
+    }
+  }
+
+  // worker thread. one file in, one file out, one journal line on success.
+  void processOne(juce::File inputFile, juce::String key) {
+    // process() replaces its input in place, so work on a scratch copy and
+    // rename it to the final name only once the model is done with it
+    juce::File outputFile = m_outputDir.getChildFile(inputFile.getFileName());
+    juce::File scratch = m_outputDir.getChildFile(
+        inputFile.getFileNameWithoutExtension() + "_processing" + inputFile.getFileExtension());
+
+    bool succeeded = false;
+
+    try {
+      scratch.deleteFile();
+
+      if (!inputFile.copyFileTo(scratch)) {
+        throw std::runtime_error("Failed to copy input to the output directory.");
+      }
+
+      m_model->process(scratch);
+
+      outputFile.deleteFile();
+      succeeded = scratch.moveFileTo(outputFile);
+    } catch (const std::exception& e) {
+      DBG("Watch-folder: processing " + inputFile.getFileName() + " failed: " + juce::String(e.what()));
+    }
+
+    scratch.deleteFile();
+
+    juce::MessageManager::callAsync([this, inputFile, key, succeeded] {
+      m_inProgress.erase(key);
+
+      if (succeeded) {
+        appendToJournal(key);
+        m_numProcessed++;
+        DBG("Watch-folder: done with " + inputFile.getFileName()
+                  + " (" + juce::String(m_numProcessed.load()) + " total)");
+      } else {
+        // remembered in memory only, so a poison file doesn't spin the
+        // scanner - a restart (or a fresh copy of the file) retries it
+        m_failed.insert(key);
+      }
+    });
+  }
+
+  static bool isSupportedMediaFile(const juce::File& file) {
+    juce::String extension = file.getFileExtension().toLowerCase();
+
+    return extension == ".wav" || extension == ".bwf"
+        || extension == ".aiff" || extension == ".aif"
+        || extension == ".flac" || extension == ".mp3"
+        || extension == ".mid" || extension == ".midi";
+  }
+
+  // name + size + mtime, so a re-dropped newer version of a file is new work
+  static juce::String journalKeyFor(const juce::File& file) {
+    return file.getFileName() + "|" + juce::String(file.getSize())
+        + "|" + juce::String(file.getLastModificationTime().toMilliseconds());
+  }
+
+  juce::File journalFile() const {
+    return m_outputDir.getChildFile(".harp_journal");
+  }
+
+  void readJournal() {
+    juce::StringArray lines;
+    lines.addLines(journalFile().loadFileAsString());
+
+    for (const auto& line : lines) {
+      if (line.isNotEmpty()) {
+        m_completed.insert(line);
+      }
+    }
+
+    if (!m_completed.empty()) {
+      DBG("Watch-folder: journal lists " + juce::String((int) m_completed.size()) + " completed files");
+    }
+  }
+
+  void appendToJournal(const juce::String& key) {
+    m_completed.insert(key);
+    journalFile().appendText(key + "\n");
+  }
+
+  juce::File m_watchDir;
+  juce::File m_outputDir;
+  std::string m_modelUrl;
+  int m_maxInFlight;
+
+  std::shared_ptr<WebModel> m_model { std::make_shared<WebModel>() };
+  JobScheduler m_scheduler;
+
+  // message-thread state (the scanner and completion callbacks both run there)
+  std::map<juce::String, juce::int64> m_lastSeenSizes;
+  std::set<juce::String> m_completed;
+  std::set<juce::String> m_inProgress;
+  std::set<juce::String> m_failed;
+
+  std::atomic<int> m_numProcessed { 0 };
+};
@@ -9,55 +9,78 @@
 
 #pragma once
 
+#include <algorithm>
 #include <fstream>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
 
 
+#include "AsyncLogger.h"
 #include "Model.h"
+#include "Trace.h"
 
 #include "juce_core/juce_core.h"
+#include "juce_audio_formats/juce_audio_formats.h"
 // #include "juce_data_structres/juce_data_structures.h"
 
 
-struct Ctrl {
+// the fields every control shares. the concrete control types below are
+// plain structs held by value in a std::variant - no vtables, no RTTI, and
+// the whole panel lives in one contiguous vector.
+struct CtrlBase {
   juce::Uuid id {""};
   std::string label {""};
-  virtual ~Ctrl() = default; // virtual destructor
 };
 
-struct SliderCtrl : public Ctrl {
+struct SliderCtrl : public CtrlBase {
   double minimum;
   double maximum;
   double step;
   double value;
 };
 
-struct TextBoxCtrl : public Ctrl {
+struct TextBoxCtrl : public CtrlBase {
   std::string value;
 };
 
-struct AudioInCtrl : public Ctrl {
+struct AudioInCtrl : public CtrlBase {
   std::string value;
 };
 
-struct MidiInCtrl : public Ctrl {
+struct MidiInCtrl : public CtrlBase {
   std::string value;
 };
 
-struct NumberBoxCtrl : public Ctrl {
+struct NumberBoxCtrl : public CtrlBase {
   double min;
   double max;
   double value;
 };
 
-struct ToggleCtrl : public Ctrl {
+struct ToggleCtrl : public CtrlBase {
   bool value;
 };
 
-struct ComboBoxCtrl : public Ctrl {
+struct ComboBoxCtrl : public CtrlBase {
   std::vector<std::string> options;
   std::string value;
 };
 
+using CtrlVariant = std::variant<SliderCtrl, TextBoxCtrl, AudioInCtrl, MidiInCtrl,
+                                 NumberBoxCtrl, ToggleCtrl, ComboBoxCtrl>;
+
+// access to the shared fields of whichever alternative a variant holds
+inline CtrlBase& ctrlBase(CtrlVariant& ctrl) {
+  return std::visit([](auto& c) -> CtrlBase& { return c; }, ctrl);
+}
+
+inline const CtrlBase& ctrlBase(const CtrlVariant& ctrl) {
+  return std::visit([](const auto& c) -> const CtrlBase& { return c; }, ctrl);
+}
+
 
 juce::String resolveSpaceUrl(juce::String urlOrName) {
   if (urlOrName.contains("localhost") || urlOrName.contains("huggingface.co") || urlOrName.contains("http")) {
@@ -70,7 +93,37 @@ juce::String resolveSpaceUrl(juce::String urlOrName) {
   return urlOrName;
 }
 
-using CtrlList = std::vector<std::pair<juce::Uuid, std::shared_ptr<Ctrl>>>;
+// contiguous control storage with an O(1) uuid -> slot index, so saveCtrls
+// is a single branch-predictable pass and the per-widget lookups the UI does
+// on every change never scan the whole panel
+class CtrlList {
+public:
+  void clear() {
+    m_ctrls.clear();
+    m_index.clear();
+  }
+
+  void add(CtrlVariant ctrl) {
+    m_index[ctrlBase(ctrl).id.toString().toStdString()] = m_ctrls.size();
+    m_ctrls.push_back(std::move(ctrl));
+  }
+
+  CtrlVariant* findByUuid(const juce::Uuid& uuid) {
+    auto it = m_index.find(uuid.toString().toStdString());
+    return it == m_index.end() ? nullptr : &m_ctrls[it->second];
+  }
+
+  auto begin() { return m_ctrls.begin(); }
+  auto end() { return m_ctrls.end(); }
+  auto begin() const { return m_ctrls.begin(); }
+  auto end() const { return m_ctrls.end(); }
+
+  size_t size() const { return m_ctrls.size(); }
+
+private:
+  std::vector<CtrlVariant> m_ctrls;
+  std::unordered_map<std::string, size_t> m_index;
+};
 
 namespace{
 
@@ -82,45 +135,55 @@ public:
 
   WebModel() { // TODO: should be a singleton
 
-    // create our logger
-    m_logger.reset(juce::FileLogger::createDefaultAppLogger("HARP", "webmodel.log", "hello, harp!"));
+    // create our logger. writes happen on its background thread, so a slow
+    // disk can't stall load()/process() mid-flight.
+    m_logger = std::make_unique<AsyncLogger>(
+        juce::FileLogger::getSystemLogFileFolder().getChildFile("HARP").getChildFile("webmodel.log"),
+        "hello, harp!");
 
     m_status_flag_file.replaceWithText("Status.INITIALIZED");
 
     #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+      std::system("start /B cmd /c set PYTHONIOENCODING=UTF-8");
+    #endif
 
-      scriptPath = juce::File::getSpecialLocation(
+    scriptPath = helperScriptPath();
+    prefix_cmd = "";
+  }
+
+  // resolves the bundled gradiojuce_client helper binary for this platform
+  static juce::File helperScriptPath() {
+    #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+      return juce::File::getSpecialLocation(
         juce::File::currentApplicationFile
       ).getParentDirectory().getChildFile("Resources/gradiojuce_client/gradiojuce_client.exe");
-
-      std::system("start /B cmd /c set PYTHONIOENCODING=UTF-8");
     #elif __APPLE__
-      scriptPath = juce::File::getSpecialLocation(
+      return juce::File::getSpecialLocation(
           juce::File::currentApplicationFile
       ).getChildFile("Contents/Resources/gradiojuce_client/gradiojuce_client");
-      prefix_cmd = "";
     #elif __linux__
-      scriptPath = juce::File::getSpecialLocation(
+      return juce::File::getSpecialLocation(
           juce::File::currentApplicationFile
       ).getParentDirectory().getChildFile("Resources/gradiojuce_client/gradiojuce_client");
-      prefix_cmd = "";
     #else
       #error "gradiojuce_client has not been implemented for this platform"
     #endif
-
   }
 
   ~WebModel() {
+    stopDaemon();
+
     // clean up flag files
     m_cancel_flag_file.deleteFile();
     m_status_flag_file.deleteFile();
   }
 
-  void LogAndDBG(const juce::String& message) const {
+  void LogAndDBG(const juce::String& message,
+                 AsyncLogger::Level level = AsyncLogger::Level::info) const {
     DBG(message);
 
     if (m_logger) {
-      m_logger->logMessage(message);
+      m_logger->logMessage(message, level);
     }
   }
 
@@ -134,15 +197,111 @@ public:
       LogAndDBG("Process failed!");
     }
 
-    juce::String output = process.readAllProcessOutput();
-    juce::uint32 exit_code = process.getExitCode();
+    // registered while we block on its output, so cancel() can hard-kill a
+    // helper that ignores the cancel flag (e.g. one stuck mid-upload)
+    ScopedChildRegistration registration(m_children, &process);
+
+    // incremental line-buffered read instead of one blocking
+    // readAllProcessOutput: error lines hit the log the moment the helper
+    // prints them instead of after it exits, and retention is bounded so a
+    // chatty helper can't balloon memory over a long job.
+    juce::String output;
+    juce::MemoryOutputStream lineBuffer;
+    char readChunk[4096];
+
+    while (true) {
+      const int numRead = process.readProcessOutput(readChunk, (int) sizeof(readChunk));
+
+      if (numRead <= 0) {
+        if (!process.isRunning()) {
+          break;
+        }
+
+        juce::Thread::sleep(5);
+        continue;
+      }
+
+      for (int i = 0; i < numRead; ++i) {
+        if (readChunk[i] != '\n') {
+          lineBuffer.writeByte(readChunk[i]);
+          continue;
+        }
+
+        juce::String line = lineBuffer.toString();
+        lineBuffer.reset();
+
+        // surface failures live - a traceback mid-job shows up in the log
+        // immediately, not minutes later when the process finally dies
+        if (line.contains("Error") || line.contains("Traceback")) {
+          LogAndDBG(line, AsyncLogger::Level::error);
+        }
+
+        output << line << "\n";
 
-    // LogAndDBG("Process output: " + output);
-    // LogAndDBG("Exit code: " + juce::String(exit_code));
+        // keep only the most recent output; the error patterns the callers
+        // search for show up at the end of a crashing run anyway
+        if (output.length() > maxRetainedOutputChars) {
+          output = "(helper output truncated)\n"
+              + output.substring(output.length() - maxRetainedOutputChars / 2);
+        }
+      }
+    }
+
+    if (lineBuffer.getDataSize() > 0) {
+      output << lineBuffer.toString();
+    }
+
+    juce::uint32 exit_code = process.getExitCode();
 
     return std::make_pair(output, exit_code);
   }
 
+  // runs a gradiojuce_client request, preferring the resident daemon
+  // (which keeps the python interpreter warm between calls) and falling
+  // back to a one-shot process spawn if the daemon is unavailable.
+  std::pair<juce::String, juce::uint32> run_client(const juce::var& request, const std::string& fallbackCommand) const {
+    {
+      const juce::ScopedLock lock(m_daemon_lock);
+
+      if (ensureDaemonRunning()) {
+        auto result = run_daemon_request(request);
+        if (result.has_value()) {
+          return *result;
+        }
+
+        // the daemon connection broke mid-request. drop it so the next
+        // call starts fresh, and fall through to the one-shot spawn.
+        LogAndDBG("Daemon request failed. Falling back to a one-shot process spawn.");
+        const juce::ScopedLock writeLock(m_daemon_write_lock);
+        m_daemon_socket.reset();
+      }
+    }
+
+    // without the push channel, the status flag file is authoritative again
+    {
+      const juce::ScopedLock lock(m_status_lock);
+      m_status.clear();
+    }
+
+    LogAndDBG("Running command: " + fallbackCommand);
+    return run_command(fallbackCommand);
+  }
+
+  // kills the resident daemon (if any). called from the destructor,
+  // but safe to call at any time; the next request will restart it.
+  void stopDaemon() {
+    const juce::ScopedLock lock(m_daemon_lock);
+
+    {
+      const juce::ScopedLock writeLock(m_daemon_write_lock);
+      m_daemon_socket.reset();
+    }
+
+    if (m_daemon_process.isRunning()) {
+      m_daemon_process.kill();
+    }
+  }
+
   bool ready() const override { return m_loaded; }
   std::string space_url() const { return m_url; }
 
@@ -151,6 +310,8 @@ public:
   }
 
   void load(const map<string, any> &params) override {
+    HARP_TRACE("model.load");
+
     m_ctrls.clear();
     m_loaded = false;
 
@@ -163,6 +324,30 @@ public:
     m_url = url; // Store the URL for future use
     LogAndDBG("url: " + m_url);
 
+    // if we have a fresh cached control spec for this space, populate the UI
+    // from it instantly and revalidate against the space in the background
+    juce::File cacheFile = getControlSpecCacheFile(m_url);
+    if (cacheFile.existsAsFile()
+        && juce::Time::getCurrentTime() - cacheFile.getLastModificationTime() < juce::RelativeTime::hours(24)) {
+      juce::var cached = loadJsonFromFile(cacheFile);
+
+      if (!cached.isVoid()) {
+        try {
+          parseControlSpec(cached);
+          m_loaded = true;
+
+          setStatus("Status.LOADED");
+          m_status_flag_file.replaceWithText("Status.LOADED");
+
+          LogAndDBG("Loaded control spec for " + m_url + " from cache. Revalidating in the background.");
+          revalidateControlSpecAsync(prefix_cmd, scriptPath, m_url, cacheFile);
+          return;
+        } catch (const std::runtime_error& e) {
+          LogAndDBG("Cached control spec was unusable: " + juce::String(e.what()));
+        }
+      }
+    }
+
     juce::File outputPath = juce::File::getSpecialLocation(juce::File::tempDirectory)
             .getChildFile("control_spec.json");
     outputPath.deleteFile();
@@ -179,12 +364,21 @@ public:
     );
 
 
-    LogAndDBG("Running command: " + command);
-    std::pair<juce::String, juce::uint32> cmd_result = run_command(command);
+    juce::DynamicObject::Ptr request = new juce::DynamicObject();
+    request->setProperty("mode", "controls");
+    request->setProperty("url", juce::String(m_url));
+    request->setProperty("output_path", outputPath.getFullPathName());
+
+    std::pair<juce::String, juce::uint32> cmd_result;
+    {
+      HARP_TRACE("model.load.fetch_controls");
+      cmd_result = run_client(juce::var(request.get()), command);
+    }
 
     juce::String logContent = cmd_result.first;
     juce::uint32 result = cmd_result.second;
-    LogAndDBG(logContent);
+    // full helper stdout dump - debug level so release builds skip it
+    LogAndDBG(logContent, AsyncLogger::Level::debug);
 
     if (result != 0) {
         // read the text from the temp log file.
@@ -229,7 +423,25 @@ public:
 
 
     // Load the output JSON and parse controls if needed (This step might need more detail based on your requirements)
+    HARP_TRACE("model.load.parse_spec");
     juce::var controls = loadJsonFromFile(outputPath);
+    parseControlSpec(controls);
+
+    // cache the raw spec so reloading the same space is instant next time
+    cacheFile.replaceWithText(outputPath.loadFileAsString());
+
+    outputPath.deleteFile();
+    m_loaded = true;
+
+    // set the status to LOADED
+    setStatus("Status.LOADED");
+    m_status_flag_file.replaceWithText("Status.LOADED");
+  }
+
+  // parses just the "card" section of a control spec into a ModelCard.
+  // shared by parseControlSpec and the combo-box card prefetcher. throws a
+  // std::runtime_error on malformed specs.
+  static ModelCard parseCardFromSpec(const juce::var& controls) {
     if (controls.isVoid()) {
         throw std::runtime_error("Failed to load controls from JSON. juce::var was void.");
     }
@@ -239,10 +451,6 @@ public:
         throw std::runtime_error("Failed to load control dict from JSON. ctrlDict is null.");
     }
 
-    // the "ctrls" key should be a list of dicts
-    // the "card" key should be the modelcard
-
-    // BEGIN  MODELCARD
     if (!ctrlDict->hasProperty("card")) {
         throw std::runtime_error("Failed to load model card from JSON. card key not found.");
     }
@@ -252,12 +460,40 @@ public:
     }
 
     // TODO: probably need to check if these properties exist and if they're the right types.
-    m_card = ModelCard();
-    m_card.name = jsonCard->getProperty("name").toString().toStdString();
-    m_card.description = jsonCard->getProperty("description").toString().toStdString();
-    m_card.author = jsonCard->getProperty("author").toString().toStdString();
-    m_card.midi_in = (bool) jsonCard->getProperty("midi_in");
-    m_card.midi_out = (bool) jsonCard->getProperty("midi_out");
+    ModelCard card;
+    card.name = jsonCard->getProperty("name").toString().toStdString();
+    card.description = jsonCard->getProperty("description").toString().toStdString();
+    card.author = jsonCard->getProperty("author").toString().toStdString();
+    card.midi_in = (bool) jsonCard->getProperty("midi_in");
+    card.midi_out = (bool) jsonCard->getProperty("midi_out");
+
+    // optional: models that support time-local processing can declare a
+    // window length to opt into the chunked streaming round-trip
+    if (jsonCard->hasProperty("chunk_duration")) {
+      card.chunk_duration = (double) jsonCard->getProperty("chunk_duration");
+    } else {
+      card.chunk_duration = 0.0;
+    }
+
+    // optional: replicas of the same model that chunked jobs may process
+    // windows on in parallel
+    if (auto* replicas = jsonCard->getProperty("replica_urls").getArray()) {
+      for (int i = 0; i < replicas->size(); i++) {
+        card.replica_urls.push_back(replicas->getReference(i).toString().toStdString());
+      }
+    }
+
+    // optional: opt out of the FLAC transfer codec stage (e.g. spaces that
+    // inspect the original container)
+    if (jsonCard->hasProperty("flac_transfer")) {
+      card.flac_transfer = (bool) jsonCard->getProperty("flac_transfer");
+    }
+
+    // optional: the rate the model resamples everything to server-side,
+    // letting us do it client-side and upload fewer samples
+    if (jsonCard->hasProperty("native_sample_rate")) {
+      card.native_sample_rate = (double) jsonCard->getProperty("native_sample_rate");
+    }
 
     // tags is a list of str
     juce::Array<juce::var> *tags = jsonCard->getProperty("tags").getArray();
@@ -265,9 +501,20 @@ public:
         throw std::runtime_error("Failed to load tags from JSON. tags is null.");
     }
     for (int i = 0; i < tags->size(); i++) {
-      m_card.tags.push_back(tags->getReference(i).toString().toStdString());
+      card.tags.push_back(tags->getReference(i).toString().toStdString());
     }
-    // END MODELCARD
+
+    return card;
+  }
+
+  // parses a control spec (the JSON written by the helper's controls mode)
+  // into m_card and m_ctrls. throws a std::runtime_error on malformed specs.
+  void parseControlSpec(const juce::var& controls) {
+    // the "ctrls" key should be a list of dicts
+    // the "card" key should be the modelcard
+    m_card = parseCardFromSpec(controls);
+
+    juce::DynamicObject *ctrlDict = controls.getDynamicObject();
 
     if (!ctrlDict->hasProperty("ctrls")) {
         throw std::runtime_error("Failed to load controls from JSON. ctrls key not found.");
@@ -294,53 +541,53 @@ public:
           juce::String ctrl_type = ctrl["ctrl_type"].toString().toStdString();
 
           // For the first two, we are abusing the term control.
-          // They are actually the main inputs to the model (audio or midi) 
+          // They are actually the main inputs to the model (audio or midi)
           if (ctrl_type == "audio_in") {
-            auto audio_in = std::make_shared<AudioInCtrl>();
-            audio_in->label = ctrl["label"].toString().toStdString();
+            AudioInCtrl audio_in;
+            audio_in.label = ctrl["label"].toString().toStdString();
 
-            m_ctrls.push_back({audio_in->id, audio_in});
-            LogAndDBG("Audio In: " + audio_in->label + " added");
+            m_ctrls.add(audio_in);
+            LogAndDBG("Audio In: " + audio_in.label + " added");
           }
           else if (ctrl_type == "midi_in") {
-            auto midi_in = std::make_shared<MidiInCtrl>();
-            midi_in->label = ctrl["label"].toString().toStdString();
+            MidiInCtrl midi_in;
+            midi_in.label = ctrl["label"].toString().toStdString();
 
-            m_ctrls.push_back({midi_in->id, midi_in});
-            LogAndDBG("MIDI In: " + midi_in->label + " added");
+            m_ctrls.add(midi_in);
+            LogAndDBG("MIDI In: " + midi_in.label + " added");
           }
           // The rest are the actual controls that map to hyperparameters
           // of the model
           else if (ctrl_type == "slider") {
-            auto slider = std::make_shared<SliderCtrl>();
-            slider->id = juce::Uuid();
-            slider->label = ctrl["label"].toString().toStdString();
-            slider->minimum = ctrl["minimum"].toString().getFloatValue();
-            slider->maximum = ctrl["maximum"].toString().getFloatValue();
-            slider->step = ctrl["step"].toString().getFloatValue();
-            slider->value = ctrl["value"].toString().getFloatValue();
-
-            m_ctrls.push_back({slider->id, slider});
-            LogAndDBG("Slider: " + slider->label + " added");
+            SliderCtrl slider;
+            slider.id = juce::Uuid();
+            slider.label = ctrl["label"].toString().toStdString();
+            slider.minimum = ctrl["minimum"].toString().getFloatValue();
+            slider.maximum = ctrl["maximum"].toString().getFloatValue();
+            slider.step = ctrl["step"].toString().getFloatValue();
+            slider.value = ctrl["value"].toString().getFloatValue();
+
+            m_ctrls.add(slider);
+            LogAndDBG("Slider: " + slider.label + " added");
           }
           else if (ctrl_type == "text") {
-            auto text = std::make_shared<TextBoxCtrl>();
-            text->id = juce::Uuid();
-            text->label = ctrl["label"].toString().toStdString();
-            text->value = ctrl["value"].toString().toStdString();
+            TextBoxCtrl text;
+            text.id = juce::Uuid();
+            text.label = ctrl["label"].toString().toStdString();
+            text.value = ctrl["value"].toString().toStdString();
 
-            m_ctrls.push_back({text->id, text});
-            LogAndDBG("Text: " + text->label + " added");
+            m_ctrls.add(text);
+            LogAndDBG("Text: " + text.label + " added");
           }
           else if (ctrl_type == "number_box") {
-            auto number_box = std::make_shared<NumberBoxCtrl>();
-            number_box->label = ctrl["label"].toString().toStdString();
-            number_box->min = ctrl["min"].toString().getFloatValue();
-            number_box->max = ctrl["max"].toString().getFloatValue();
-            number_box->value = ctrl["value"].toString().getFloatValue();
-
-            m_ctrls.push_back({number_box->id, number_box});
-            LogAndDBG("Number Box: " + number_box->label + " added");
+            NumberBoxCtrl number_box;
+            number_box.label = ctrl["label"].toString().toStdString();
+            number_box.min = ctrl["min"].toString().getFloatValue();
+            number_box.max = ctrl["max"].toString().getFloatValue();
+            number_box.value = ctrl["value"].toString().getFloatValue();
+
+            m_ctrls.add(number_box);
+            LogAndDBG("Number Box: " + number_box.label + " added");
           }
           else {
             LogAndDBG("failed to parse control with unknown type: " + ctrl_type);
@@ -350,57 +597,202 @@ public:
           throw std::runtime_error("Failed to load controls from JSON. " + std::string(e));
         }
       }
-
-    outputPath.deleteFile();
-    m_loaded = true;
-
-    // set the status to LOADED
-    m_status_flag_file.replaceWithText("Status.LOADED");
   }
 
   CtrlList& controls() {
     return m_ctrls;
   }
 
+  // the current value of every control, in ctrl-list order - what the
+  // session snapshot persists between runs
+  juce::var getCtrlValues() const {
+    juce::Array<juce::var> values;
+
+    for (const auto& ctrl : m_ctrls) {
+      std::visit([&](const auto& c) {
+        using T = std::decay_t<decltype(c)>;
+
+        if constexpr (std::is_same_v<T, AudioInCtrl> || std::is_same_v<T, MidiInCtrl>) {
+          values.add(juce::var()); // the media input path isn't a user setting
+        } else {
+          values.add(juce::var(c.value));
+        }
+      }, ctrl);
+    }
+
+    return juce::var(values);
+  }
+
+  // re-applies values captured by getCtrlValues onto a freshly parsed spec.
+  // matched by index, so it only makes sense against the same model; extra
+  // or type-mismatched entries are skipped.
+  void setCtrlValues(const juce::var& values) {
+    auto* list = values.getArray();
+    if (list == nullptr) {
+      return;
+    }
+
+    int index = 0;
+
+    for (auto& ctrl : m_ctrls) {
+      if (index >= list->size()) {
+        break;
+      }
+
+      const juce::var& value = list->getReference(index++);
+      if (value.isVoid()) {
+        continue;
+      }
+
+      std::visit([&](auto& c) {
+        using T = std::decay_t<decltype(c)>;
+
+        if constexpr (std::is_same_v<T, SliderCtrl> || std::is_same_v<T, NumberBoxCtrl>) {
+          c.value = (double) value;
+        } else if constexpr (std::is_same_v<T, ToggleCtrl>) {
+          c.value = (bool) value;
+        } else if constexpr (std::is_same_v<T, TextBoxCtrl> || std::is_same_v<T, ComboBoxCtrl>) {
+          c.value = value.toString().toStdString();
+        }
+      }, ctrl);
+    }
+  }
+
   void process(juce::File filetoProcess) const {
+    HARP_TRACE("model.process");
+
     // clear the cancel flag file
     m_cancel_flag_file.deleteFile();
 
+    // forget any prefix left over from the previous job
+    setPartialOutput(juce::File());
+
     // make sure we're loaded
     LogAndDBG("WebModel::process");
     if (!m_loaded) {
       throw std::runtime_error("Model not loaded");
     }
 
-    // a random string to append to the input/output.mid files
+    // models that declare a chunk duration in their card stream long audio
+    // through the helper window by window instead of as one atomic blob
+    if (m_card.chunk_duration > 0.0 && chunkedOutputFormatFor(filetoProcess) != nullptr) {
+      processChunked(filetoProcess);
+
+      LogAndDBG("WebModel::process done");
+
+      // clear the cancel flag file
+      m_cancel_flag_file.deleteFile();
+      return;
+    }
+
+    // a random string to append to the output files
     // This is necessary because more than 1 playback regions
     // are processed at the same time.
     std::string randomString = juce::Uuid().toString().toStdString();
 
-    // save the buffer to file
-    LogAndDBG("Saving buffer to file");
-    juce::File tempFile =
-        juce::File::getSpecialLocation(juce::File::tempDirectory)
-            .getChildFile("input_" + randomString + ".mid");
-    tempFile.deleteFile();
-    // copy the file to a temp file
-    filetoProcess.copyFileTo(tempFile);
+    // transfer codec stage: hand the helper a FLAC instead of raw pcm, so
+    // the WAN round-trip moves roughly half the bytes
+    juce::File uploadFile;
+    {
+      HARP_TRACE("model.process.encode");
+      uploadFile = encodeForUpload(filetoProcess);
+    }
+    const bool compressed = uploadFile != filetoProcess;
 
-    // a tarrget output file
+    // a target output file in the exchange directory
     juce::File tempOutputFile =
-        juce::File::getSpecialLocation(juce::File::tempDirectory)
-            .getChildFile("output_" + randomString + ".mid");
+        getExchangeDirectory().getChildFile("output_" + randomString + uploadFile.getFileExtension());
+    tempOutputFile.deleteFile();
+
+    runProcessJob(uploadFile, tempOutputFile);
+
+    // a failed helper run throws out of runProcessJob, so reaching this
+    // point with no output file means the helper exited cleanly without
+    // writing one - which is what a mid-job cancel looks like
+    if (!tempOutputFile.existsAsFile()) {
+      if (compressed) {
+        uploadFile.deleteFile();
+      }
+
+      if (m_cancel_flag_file.existsAsFile()) {
+        LogAndDBG("WebModel::process cancelled before the helper produced output");
+        m_cancel_flag_file.deleteFile();
+        return;
+      }
+
+      throw std::runtime_error("The model returned no output file."
+                               " Check the logs " + m_logger->getLogFile().getFullPathName().toStdString()
+                               + " for more details.");
+    }
+
+    if (compressed) {
+      uploadFile.deleteFile();
+
+      // decode the result back into the input's own format before it takes
+      // the input's place
+      HARP_TRACE("model.process.decode");
+      juce::File decoded =
+          getExchangeDirectory().getChildFile("decoded_" + randomString + filetoProcess.getFileExtension());
+
+      if (!transcodeAudioFile(tempOutputFile, decoded, 0.0)) {
+        tempOutputFile.deleteFile();
+        throw std::runtime_error("Failed to decode the model output."
+                                 " Check the logs " + m_logger->getLogFile().getFullPathName().toStdString()
+                                 + " for more details.");
+      }
+
+      tempOutputFile.deleteFile();
+      tempOutputFile = decoded;
+    }
+
+    // move the temp output file to the original input file
+    // (a rename within a filesystem; if the exchange directory lives on a
+    // different filesystem than the input, stage a copy next to the
+    // destination and rename that instead - the input may be a hard-linked
+    // undo version, so it must never be overwritten in place)
+    {
+        HARP_TRACE("model.process.move_output");
+
+        if (!tempOutputFile.moveFileTo(filetoProcess)) {
+            juce::File staging = filetoProcess.getSiblingFile(
+                filetoProcess.getFileNameWithoutExtension() + "_staging" + filetoProcess.getFileExtension());
+
+            tempOutputFile.copyFileTo(staging);
+            staging.moveFileTo(filetoProcess);
+        }
+    }
+
     tempOutputFile.deleteFile();
 
-    // a ctrls file
+    // the final output supersedes any partial prefix
+    setPartialOutput(juce::File());
+
+    LogAndDBG("WebModel::process done");
+
+    // clear the cancel flag file
+    m_cancel_flag_file.deleteFile();
+    return;
+  }
+
+  // runs one helper process invocation: saves the current controls pointing
+  // at inputFile, sends the request, and leaves the model output at
+  // outputFile. shared by the whole-file and chunked paths.
+  void runProcessJob(const juce::File& inputFile, const juce::File& outputFile) const {
+    // exchange files live in a memory-backed directory where available,
+    // so they never cost us actual disk I/O.
     juce::File tempCtrlsFile =
-        juce::File::getSpecialLocation(juce::File::tempDirectory)
-            .getChildFile("ctrls_" + randomString + ".json");
+        getExchangeDirectory().getChildFile("ctrls_" + juce::Uuid().toString().toStdString() + ".json");
     tempCtrlsFile.deleteFile();
 
+    // NOTE: the input is handed to the helper in place. the file we get from
+    // MediaDisplayComponent is already a scratch copy owned by HARP, so there's
+    // no reason to traverse the sample data through the filesystem again here.
     LogAndDBG("saving controls...");
-    if (!saveCtrls(tempCtrlsFile, tempFile.getFullPathName().toStdString())) {
-      throw std::runtime_error("Failed to save controls to file.");
+    {
+      HARP_TRACE("model.process.save_ctrls");
+      if (!saveCtrls(tempCtrlsFile, inputFile.getFullPathName().toStdString())) {
+        throw std::runtime_error("Failed to save controls to file.");
+      }
     }
 
 
@@ -409,23 +801,36 @@ public:
         + scriptPath.getFullPathName().toStdString()
         + " --mode process"
         + " --url " + m_url
-        + " --output_path " + tempOutputFile.getFullPathName().toStdString()
+        + " --output_path " + outputFile.getFullPathName().toStdString()
         + " --ctrls_path " + tempCtrlsFile.getFullPathName().toStdString()
         + " --cancel_flag_path " + m_cancel_flag_file.getFullPathName().toStdString()
         + " --status_flag_path " + m_status_flag_file.getFullPathName().toStdString()
         // + " >> " + tempLogFile.getFullPathName().toStdString()   // redirect stdout to the temp log file
         // + " 2>&1"   // redirect stderr to the same file as stdout
     );
-    LogAndDBG("Running command: " + command);
-    std::pair<juce::String, int> cmd_result = run_command(command);
+    juce::DynamicObject::Ptr request = new juce::DynamicObject();
+    request->setProperty("mode", "process");
+    request->setProperty("url", juce::String(m_url));
+    request->setProperty("output_path", outputFile.getFullPathName());
+    request->setProperty("ctrls_path", tempCtrlsFile.getFullPathName());
+    request->setProperty("cancel_flag_path", m_cancel_flag_file.getFullPathName());
+    request->setProperty("status_flag_path", m_status_flag_file.getFullPathName());
+
+    std::pair<juce::String, juce::uint32> cmd_result;
+    {
+      // this span covers upload, inference and download on the helper side
+      HARP_TRACE("model.process.helper");
+      cmd_result = run_client(juce::var(request.get()), command);
+    }
 
     juce::String logContent = cmd_result.first;
     juce::uint32 result = cmd_result.second;
-    LogAndDBG(logContent);
+    // full helper stdout dump - debug level so release builds skip it
+    LogAndDBG(logContent, AsyncLogger::Level::debug);
 
     if (result != 0) {
         // read the text from the temp log file.
-        
+
         std::string message;
         // check for a generic Error: in the log content
         if (logContent.contains("Error:")) {
@@ -444,30 +849,333 @@ public:
         }
 
         message += "\n Check the logs " + m_logger->getLogFile().getFullPathName().toStdString() + " for more details.";
+
+        tempCtrlsFile.deleteFile();
+        throw std::runtime_error(message);
     }
 
-    // move the temp output file to the original input file
-    tempOutputFile.moveFileTo(filetoProcess);
+    tempCtrlsFile.deleteFile();
+  }
 
-    // delete the temp input file
-    tempFile.deleteFile();
-    tempOutputFile.deleteFile();
+  // like runProcessJob, but pinned to a specific replica url and always a
+  // one-shot process spawn: the resident daemon serializes its requests, so
+  // chunks running concurrently have to bypass it.
+  void runProcessJobOneShot(const std::string& url, const juce::File& inputFile,
+                            const juce::File& outputFile) const {
+    juce::File tempCtrlsFile =
+        getExchangeDirectory().getChildFile("ctrls_" + juce::Uuid().toString().toStdString() + ".json");
     tempCtrlsFile.deleteFile();
-    LogAndDBG("WebModel::process done");
 
-    // clear the cancel flag file
-    m_cancel_flag_file.deleteFile();
-    return;
+    if (!saveCtrls(tempCtrlsFile, inputFile.getFullPathName().toStdString())) {
+      throw std::runtime_error("Failed to save controls to file.");
+    }
+
+    std::string command = (
+        prefix_cmd
+        + scriptPath.getFullPathName().toStdString()
+        + " --mode process"
+        + " --url " + url
+        + " --output_path " + outputFile.getFullPathName().toStdString()
+        + " --ctrls_path " + tempCtrlsFile.getFullPathName().toStdString()
+        + " --cancel_flag_path " + m_cancel_flag_file.getFullPathName().toStdString()
+        + " --status_flag_path " + m_status_flag_file.getFullPathName().toStdString()
+    );
+
+    {
+      HARP_TRACE("model.process.helper");
+      auto cmd_result = run_command(command);
+      // full helper stdout dump - debug level so release builds skip it
+      LogAndDBG(cmd_result.first, AsyncLogger::Level::debug);
+    }
+
+    tempCtrlsFile.deleteFile();
+  }
+
+  // the full set of endpoints a chunked job may fan windows out to: the
+  // loaded space first, then any replicas its card declares
+  std::vector<std::string> processingReplicas() const {
+    std::vector<std::string> urls { m_url };
+
+    for (const auto& url : m_card.replica_urls) {
+      if (std::find(urls.begin(), urls.end(), url) == urls.end()) {
+        urls.push_back(url);
+      }
+    }
+
+    return urls;
+  }
+
+  // streams a long audio file through the helper as a pipeline of
+  // overlapping windows: each chunk is cut, processed, and crossfaded into
+  // an incrementally written output, so peak memory stays bounded by the
+  // chunk size and results appear long before the whole file is done.
+  void processChunked(juce::File filetoProcess) const {
+    LogAndDBG("WebModel::processChunked");
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    auto reader = juce::rawToUniquePtr(formatManager.createReaderFor(filetoProcess));
+    if (reader == nullptr) {
+      throw std::runtime_error("Failed to open audio file for chunked processing.");
+    }
+
+    const double inputSampleRate = reader->sampleRate;
+    const juce::int64 totalSamples = reader->lengthInSamples;
+
+    const juce::int64 chunkSamples = juce::jmax((juce::int64) 1,
+        (juce::int64) (m_card.chunk_duration * inputSampleRate));
+
+    // up to a second of overlap for the stitching crossfade
+    const juce::int64 overlapSamples = juce::jmin(chunkSamples / 4, (juce::int64) inputSampleRate);
+    const juce::int64 hopSamples = juce::jmax((juce::int64) 1, chunkSamples - overlapSamples);
+
+    juce::File exchangeDir = getExchangeDirectory();
+    std::string randomString = juce::Uuid().toString().toStdString();
+
+    const std::string chunkExtension = compressedTransferEnabled(filetoProcess) ? ".flac" : ".wav";
+
+    // the stitched result is written incrementally next to the input and
+    // swapped in at the end
+    juce::File stitchedFile = filetoProcess.getSiblingFile(
+        filetoProcess.getFileNameWithoutExtension() + "_stitched" + filetoProcess.getFileExtension());
+    stitchedFile.deleteFile();
+
+    std::unique_ptr<juce::AudioFormat> outputFormat = chunkedOutputFormatFor(filetoProcess);
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    // windows go out in waves of one chunk per replica. with a single
+    // endpoint this degenerates to the original sequential pipeline (and
+    // keeps using the warm daemon); with replicas declared in the card, a
+    // wave's windows are processed concurrently and stitched in order, so
+    // wall-clock time scales down with the replica count while peak memory
+    // stays bounded by the wave size.
+    const std::vector<std::string> replicas = processingReplicas();
+
+    juce::AudioBuffer<float> previousTail; // carried overlap, not yet written
+    int chunkIdx = 0;
+    juce::int64 start = 0;
+
+    while (start < totalSamples) {
+      struct PendingChunk {
+        int idx;
+        juce::File in;
+        juce::File out;
+        bool isLastChunk;
+      };
+
+      std::vector<PendingChunk> wave;
+
+      // cut one input window per replica out to exchange files. with the
+      // transfer codec stage on, the windows travel as FLAC and the helper's
+      // downloads come back the same way - the stitch reader below doesn't
+      // care which it gets.
+      for (size_t w = 0; w < replicas.size() && start < totalSamples; ++w, start += hopSamples, ++chunkIdx) {
+        const int numSamples = (int) juce::jmin(chunkSamples, totalSamples - start);
+
+        juce::AudioBuffer<float> chunk((int) reader->numChannels, numSamples);
+        reader->read(&chunk, 0, numSamples, start, true, true);
+
+        juce::File chunkIn = exchangeDir.getChildFile("chunk_" + std::to_string(chunkIdx) + "_" + randomString + chunkExtension);
+        writeChunk(chunkIn, chunk, inputSampleRate);
+
+        juce::File chunkOut = exchangeDir.getChildFile("chunk_out_" + std::to_string(chunkIdx) + "_" + randomString + chunkExtension);
+        chunkOut.deleteFile();
+
+        wave.push_back({ chunkIdx, chunkIn, chunkOut, start + numSamples >= totalSamples });
+      }
+
+      if (wave.size() == 1 && replicas.size() == 1) {
+        runProcessJob(wave.front().in, wave.front().out);
+      } else {
+        // fan the wave out, one window per replica. cancellation still works:
+        // every spawn watches the shared cancel flag file.
+        std::vector<std::thread> workers;
+        std::string firstError;
+        juce::CriticalSection errorLock;
+
+        for (size_t w = 0; w < wave.size(); ++w) {
+          workers.emplace_back([this, &wave, &replicas, &firstError, &errorLock, w] {
+            try {
+              runProcessJobOneShot(replicas[w], wave[w].in, wave[w].out);
+            } catch (const std::runtime_error& e) {
+              const juce::ScopedLock lock(errorLock);
+              if (firstError.empty()) {
+                firstError = e.what();
+              }
+            }
+          });
+        }
+
+        for (auto& worker : workers) {
+          worker.join();
+        }
+
+        if (!firstError.empty()) {
+          stitchedFile.deleteFile();
+          throw std::runtime_error(firstError);
+        }
+      }
+
+      // stitch the wave back together in order
+      for (const auto& pending : wave) {
+        pending.in.deleteFile();
+
+        if (!pending.out.existsAsFile()) {
+          stitchedFile.deleteFile();
+          throw std::runtime_error("Chunked processing failed on chunk " + std::to_string(pending.idx)
+                                   + ". Check the logs " + m_logger->getLogFile().getFullPathName().toStdString()
+                                   + " for more details.");
+        }
+
+        // by content, not extension - the chunk output carries the negotiated
+        // format's name but the space decides what bytes come back
+        auto chunkReader = juce::rawToUniquePtr(
+            formatManager.createReaderFor(std::make_unique<juce::FileInputStream>(pending.out)));
+        if (chunkReader == nullptr) {
+          stitchedFile.deleteFile();
+          throw std::runtime_error("Failed to read processed chunk " + std::to_string(pending.idx) + ".");
+        }
+
+        juce::AudioBuffer<float> processed((int) chunkReader->numChannels, (int) chunkReader->lengthInSamples);
+        chunkReader->read(&processed, 0, processed.getNumSamples(), 0, true, true);
+
+        if (writer == nullptr) {
+          // the model's first chunk determines the output format
+          auto stream = std::make_unique<juce::FileOutputStream>(stitchedFile);
+
+          if (stream->openedOk()) {
+            writer.reset(outputFormat->createWriterFor(stream.get(), chunkReader->sampleRate,
+                                                       chunkReader->numChannels, 24, {}, 0));
+          }
+
+          if (writer == nullptr) {
+            throw std::runtime_error("Failed to create output writer for chunked processing.");
+          }
+
+          stream.release(); // the writer owns the stream now
+        }
+
+        chunkReader.reset();
+        pending.out.deleteFile();
+
+        // crossfade the carried tail of the previous chunk into this one
+        if (previousTail.getNumSamples() > 0) {
+          const int fadeLength = juce::jmin(previousTail.getNumSamples(), processed.getNumSamples());
+          const int numChannels = juce::jmin(previousTail.getNumChannels(), processed.getNumChannels());
+
+          for (int ch = 0; ch < numChannels; ++ch) {
+            auto* out = processed.getWritePointer(ch);
+            const auto* tail = previousTail.getReadPointer(ch);
+
+            for (int i = 0; i < fadeLength; ++i) {
+              const float t = (float) (i + 1) / (float) (fadeLength + 1);
+              out[i] = tail[i] * (1.0f - t) + out[i] * t;
+            }
+          }
+        }
+
+        // hold back the overlap region for the next crossfade; everything
+        // before it is final and can go straight to disk
+        const int holdSamples = pending.isLastChunk ? 0
+            : (int) juce::jmin((juce::int64) processed.getNumSamples(), overlapSamples);
+        const int writeSamples = processed.getNumSamples() - holdSamples;
+
+        if (writeSamples > 0) {
+          writer->writeFromAudioSampleBuffer(processed, 0, writeSamples);
+          writer->flush();
+        }
+
+        previousTail.setSize(processed.getNumChannels(), holdSamples, false, false, true);
+
+        for (int ch = 0; ch < processed.getNumChannels(); ++ch) {
+          previousTail.copyFrom(ch, 0, processed, ch, writeSamples, holdSamples);
+        }
+      }
+    }
+
+    reader.reset();
+    writer.reset();
+
+    // swap the stitched result in for the input (same directory, so this is
+    // a rename that never writes through a hard-linked undo version)
+    filetoProcess.deleteFile();
+    stitchedFile.moveFileTo(filetoProcess);
+
+    LogAndDBG("WebModel::processChunked done (" + juce::String(chunkIdx) + " chunks)");
   }
 
-  // sets a cancel flag file that the client can check to see if the process
-  // should be cancelled
+  // asks the helper to cancel the running job. with the daemon this is a
+  // pushed message the helper reacts to immediately; the cancel flag file
+  // remains as the fallback for the one-shot spawn path. anything that still
+  // hasn't stopped after a short deadline gets hard-killed.
   void cancel() {
+    juce::DynamicObject::Ptr message = new juce::DynamicObject();
+    message->setProperty("mode", "cancel");
+    writeDaemonLine(juce::var(message.get()));
+
     m_cancel_flag_file.deleteFile();
     m_cancel_flag_file.create();
+
+    // the graceful signals can be ignored for tens of seconds by a helper
+    // stuck mid-upload, so after the deadline any registered process is
+    // killed outright. killing the daemon mid-request unblocks the worker
+    // thread's socket read at once, and the fallback spawn that triggers
+    // sees the cancel flag and exits immediately. the registry is captured
+    // by value, so the deadline firing after a model teardown is harmless.
+    auto registry = m_children;
+    juce::Thread::launch([registry] {
+      juce::Thread::sleep(cancelKillDeadlineMs);
+
+      const juce::ScopedLock lock(registry->lock);
+      for (auto* child : registry->children) {
+        if (child->isRunning()) {
+          child->kill();
+        }
+      }
+    });
+  }
+
+  // updates the in-memory status and notifies listeners. called from the
+  // worker thread as status events arrive over the daemon socket.
+  void setStatus(const std::string& status) const {
+    {
+      const juce::ScopedLock lock(m_status_lock);
+
+      if (m_status == status) {
+        return;
+      }
+
+      m_status = status;
+    }
+
+    m_statusBroadcaster.sendChangeMessage();
+  }
+
+  // records the latest completed prefix of the running job and notifies
+  // listeners. called from the worker thread as partial-output events
+  // arrive over the daemon socket.
+  void setPartialOutput(const juce::File& partialFile) const {
+    {
+      const juce::ScopedLock lock(m_partial_lock);
+      m_partial_file = partialFile;
+    }
+
+    if (partialFile != juce::File()) {
+      m_partialBroadcaster.sendChangeMessage();
+    }
   }
 
   std::string getStatus() {
+    // prefer the status pushed over the daemon socket
+    {
+      const juce::ScopedLock lock(m_status_lock);
+
+      if (!m_status.empty()) {
+        return m_status;
+      }
+    }
+
     // if the status file doesn't exist, return Status.INACTIVE
     if (!m_status_flag_file.exists()) {
       return "Status.INACTIVE";
@@ -478,19 +1186,398 @@ public:
     return status.toStdString();
   }
 
+  // listeners are notified whenever a pushed status update arrives
+  juce::ChangeBroadcaster& statusBroadcaster() const { return m_statusBroadcaster; }
+
+  // the completed prefix of the output being generated, or an empty File if
+  // the current job hasn't yielded one (yet)
+  juce::File getPartialOutputFile() const {
+    const juce::ScopedLock lock(m_partial_lock);
+    return m_partial_file;
+  }
+
+  // listeners are notified whenever a new partial output lands
+  juce::ChangeBroadcaster& partialBroadcaster() const { return m_partialBroadcaster; }
+
   juce::File getCancelFlagFile() const {
     return m_cancel_flag_file;
   }
 
-  CtrlList::iterator findCtrlByUuid(const juce::Uuid& uuid) {
-    return std::find_if(m_ctrls.begin(), m_ctrls.end(),
-        [&uuid](const CtrlList::value_type& pair) {
-            return pair.first == uuid;
+  // returns the audio format to write the stitched output in, or nullptr if
+  // the file's format isn't one we can write (which disables chunked mode)
+  static std::unique_ptr<juce::AudioFormat> chunkedOutputFormatFor(const juce::File& file) {
+    juce::String extension = file.getFileExtension().toLowerCase();
+
+    if (extension == ".wav" || extension == ".bwf") {
+      return std::make_unique<juce::WavAudioFormat>();
+    }
+    if (extension == ".aiff" || extension == ".aif") {
+      return std::make_unique<juce::AiffAudioFormat>();
+    }
+    if (extension == ".flac") {
+      return std::make_unique<juce::FlacAudioFormat>();
+    }
+
+    return nullptr;
+  }
+
+  // writes one chunk buffer out as an exchange file for the helper, in
+  // whatever format the file's extension asks for (wav, or flac when the
+  // transfer codec stage is on)
+  static void writeChunk(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate) {
+    file.deleteFile();
+
+    std::unique_ptr<juce::AudioFormat> format = chunkedOutputFormatFor(file);
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    if (format != nullptr && stream->openedOk()) {
+      writer.reset(format->createWriterFor(stream.get(), sampleRate,
+                                           (unsigned int) buffer.getNumChannels(), 24, {}, 0));
+    }
+
+    if (writer == nullptr) {
+      throw std::runtime_error("Failed to write chunk to " + file.getFullPathName().toStdString());
+    }
+
+    stream.release(); // the writer owns the stream now
+    writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+  }
+
+  // whether the transfer codec stage applies to this file: uncompressed
+  // audio only (flac and midi pass through), and the card hasn't opted out
+  bool compressedTransferEnabled(const juce::File& file) const {
+    if (!m_card.flac_transfer) {
+      return false;
+    }
+
+    juce::String extension = file.getFileExtension().toLowerCase();
+    return extension == ".wav" || extension == ".bwf"
+        || extension == ".aiff" || extension == ".aif";
+  }
+
+  // re-encodes input into output (format from output's extension), optionally
+  // resampling to targetSampleRate (0 keeps the input rate). returns false if
+  // either end can't be opened; the caller falls back to the raw file.
+  static bool transcodeAudioFile(const juce::File& input, const juce::File& output,
+                                 double targetSampleRate) {
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    // sniff the content rather than trusting the extension: the helper names
+    // the download after the negotiated format, but a space is free to send
+    // back whatever it likes (most return WAV regardless)
+    auto reader = juce::rawToUniquePtr(
+        formatManager.createReaderFor(std::make_unique<juce::FileInputStream>(input)));
+    std::unique_ptr<juce::AudioFormat> outputFormat = chunkedOutputFormatFor(output);
+
+    if (reader == nullptr || outputFormat == nullptr) {
+      return false;
+    }
+
+    const double outputRate = targetSampleRate > 0.0 ? targetSampleRate : reader->sampleRate;
+
+    output.deleteFile();
+    auto stream = std::make_unique<juce::FileOutputStream>(output);
+
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    if (stream->openedOk()) {
+      writer.reset(outputFormat->createWriterFor(stream.get(), outputRate,
+                                                 reader->numChannels, 24, {}, 0));
+    }
+
+    if (writer == nullptr) {
+      return false;
+    }
+
+    stream.release(); // the writer owns the stream now
+
+    if (outputRate != reader->sampleRate) {
+      juce::AudioFormatReaderSource readerSource(reader.get(), false);
+      juce::ResamplingAudioSource resampler(&readerSource, false, (int) reader->numChannels);
+
+      resampler.setResamplingRatio(reader->sampleRate / outputRate);
+      resampler.prepareToPlay(2048, outputRate);
+
+      const juce::int64 outputLength =
+          (juce::int64) (reader->lengthInSamples * outputRate / reader->sampleRate);
+      bool ok = writer->writeFromAudioSource(resampler, (int) outputLength);
+
+      resampler.releaseResources();
+      return ok;
+    }
+
+    return writer->writeFromAudioReader(*reader, 0, reader->lengthInSamples);
+  }
+
+  // the transfer codec stage: transcodes an upload to FLAC (resampled to the
+  // card's native rate, if it declares one) so WAN round-trips move roughly
+  // half the bytes. returns the original file untouched when the stage
+  // doesn't apply or the encode fails.
+  juce::File encodeForUpload(const juce::File& inputFile) const {
+    if (!compressedTransferEnabled(inputFile)) {
+      return inputFile;
+    }
+
+    juce::File encoded = getExchangeDirectory().getChildFile(
+        "upload_" + juce::Uuid().toString().toStdString() + ".flac");
+
+    if (!transcodeAudioFile(inputFile, encoded, m_card.native_sample_rate)) {
+      LogAndDBG("FLAC encode failed, uploading the raw file instead.");
+      encoded.deleteFile();
+      return inputFile;
+    }
+
+    LogAndDBG("Transfer codec: " + juce::String(inputFile.getSize() / 1024) + " KB -> "
+              + juce::String(encoded.getSize() / 1024) + " KB");
+    return encoded;
+  }
+
+  // returns the on-disk cache location for a space's control spec
+  static juce::File getControlSpecCacheFile(const std::string& url) {
+    juce::File cacheDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("HARP").getChildFile("control_spec_cache");
+    cacheDir.createDirectory();
+
+    juce::String key = juce::String::toHexString(juce::String(url).hashCode64());
+    return cacheDir.getChildFile(key + ".json");
+  }
+
+  // fetches a space's model card without loading the model: serves the
+  // control spec cache when fresh, otherwise does a one-shot helper spawn in
+  // controls mode and fills the cache (so a later load() of the same space
+  // skips the network round-trip entirely). returns nullopt when the space
+  // can't be reached or its spec is malformed. static for the same reason as
+  // revalidateControlSpecAsync: prefetch jobs must survive WebModel teardown.
+  static std::optional<ModelCard> fetchCardForUrl(const std::string& url) {
+    juce::File cacheFile = getControlSpecCacheFile(url);
+
+    bool cacheFresh = cacheFile.existsAsFile()
+        && juce::Time::getCurrentTime() - cacheFile.getLastModificationTime() < juce::RelativeTime::hours(24);
+
+    if (!cacheFresh) {
+      juce::File outputPath = juce::File::getSpecialLocation(juce::File::tempDirectory)
+          .getChildFile("control_spec_prefetch_" + juce::Uuid().toString() + ".json");
+      outputPath.deleteFile();
+
+      std::string command = (
+        helperScriptPath().getFullPathName().toStdString()
+        + " --mode controls"
+        + " --url " + url
+        + " --output_path " + outputPath.getFullPathName().toStdString()
+      );
+
+      juce::ChildProcess process;
+      if (process.start(command)) {
+        process.readAllProcessOutput();
+
+        if (process.getExitCode() == 0 && outputPath.existsAsFile()) {
+          cacheFile.replaceWithText(outputPath.loadFileAsString());
         }
-    );
+      }
+
+      outputPath.deleteFile();
+    }
+
+    if (!cacheFile.existsAsFile()) {
+      return std::nullopt;
+    }
+
+    try {
+      return parseCardFromSpec(juce::JSON::parse(cacheFile.loadFileAsString()));
+    } catch (const std::runtime_error&) {
+      return std::nullopt;
+    }
+  }
+
+  // re-fetches the control spec in the background and updates the cache if
+  // the space's spec changed (picked up on the next load). deliberately
+  // detached from the model object - MainComponent tears down and rebuilds
+  // WebModel on load failures - so this copies its state and uses a one-shot
+  // helper spawn rather than the daemon.
+  static void revalidateControlSpecAsync(std::string prefix_cmd, juce::File scriptPath,
+                                         std::string url, juce::File cacheFile) {
+    juce::Thread::launch([prefix_cmd, scriptPath, url, cacheFile] {
+      juce::File outputPath = juce::File::getSpecialLocation(juce::File::tempDirectory)
+          .getChildFile("control_spec_revalidate_" + juce::Uuid().toString() + ".json");
+      outputPath.deleteFile();
+
+      std::string command = (
+        prefix_cmd
+        + scriptPath.getFullPathName().toStdString()
+        + " --mode controls"
+        + " --url " + url
+        + " --output_path " + outputPath.getFullPathName().toStdString()
+      );
+
+      juce::ChildProcess process;
+      if (process.start(command)) {
+        process.readAllProcessOutput();
+
+        if (process.getExitCode() == 0 && outputPath.existsAsFile()) {
+          juce::String fresh = outputPath.loadFileAsString();
+
+          if (fresh.isNotEmpty() && fresh != cacheFile.loadFileAsString()) {
+            DBG("Control spec for " + url + " changed. Updating cache.");
+            cacheFile.replaceWithText(fresh);
+          } else {
+            // still fresh; bump the TTL
+            cacheFile.setLastModificationTime(juce::Time::getCurrentTime());
+          }
+        }
+      }
+
+      outputPath.deleteFile();
+    });
+  }
+
+  // returns the directory used for files exchanged with the helper process.
+  // on linux we prefer /dev/shm, so exchange files live in page cache-backed
+  // shared memory and never hit the disk; elsewhere we fall back to the
+  // regular temp directory.
+  static juce::File getExchangeDirectory() {
+    #if __linux__
+      juce::File shm("/dev/shm");
+      if (shm.isDirectory()) {
+        juce::File exchangeDir = shm.getChildFile("harp_exchange");
+        if (exchangeDir.createDirectory().wasOk()) {
+          return exchangeDir;
+        }
+      }
+    #endif
+
+    return juce::File::getSpecialLocation(juce::File::tempDirectory);
+  }
+
+  // O(1) via the hash index CtrlList maintains. nullptr if unknown.
+  CtrlVariant* findCtrlByUuid(const juce::Uuid& uuid) {
+    return m_ctrls.findByUuid(uuid);
   }
 
 private:
+  // spawns the gradiojuce_client daemon (if it isn't running yet) and
+  // connects to it. returns false if the daemon couldn't be started, in
+  // which case callers should fall back to run_command().
+  // NOTE: callers must hold m_daemon_lock.
+  bool ensureDaemonRunning() const {
+    if (m_daemon_socket != nullptr && m_daemon_socket->isConnected()) {
+      return true;
+    }
+
+    m_daemon_socket.reset();
+
+    if (!m_daemon_process.isRunning()) {
+      m_daemon_port = 49152 + juce::Random::getSystemRandom().nextInt(16000);
+
+      std::string command = (
+        prefix_cmd
+        + scriptPath.getFullPathName().toStdString()
+        + " --mode daemon"
+        + " --port " + std::to_string(m_daemon_port)
+      );
+
+      LogAndDBG("Starting gradiojuce_client daemon: " + command);
+      // don't pipe the daemon's stdout/stderr: nobody reads them (logging
+      // travels over the socket), and a full pipe would block the helper's
+      // print() mid-job, deadlocking the worker waiting on the response line
+      if (!m_daemon_process.start(command, 0)) {
+        LogAndDBG("Failed to start the gradiojuce_client daemon.");
+        return false;
+      }
+    }
+
+    // the (PyInstaller-frozen) interpreter can take a few seconds to boot,
+    // so keep retrying the connection for a while before giving up
+    auto socket = std::make_unique<juce::StreamingSocket>();
+    for (int attempt = 0; attempt < 40; ++attempt) {
+      if (socket->connect("127.0.0.1", m_daemon_port, 250)) {
+        const juce::ScopedLock writeLock(m_daemon_write_lock);
+        m_daemon_socket = std::move(socket);
+        LogAndDBG("Connected to the gradiojuce_client daemon on port " + juce::String(m_daemon_port));
+        return true;
+      }
+
+      if (!m_daemon_process.isRunning()) {
+        LogAndDBG("The gradiojuce_client daemon exited before accepting a connection.");
+        return false;
+      }
+
+      juce::Thread::sleep(250);
+    }
+
+    LogAndDBG("Timed out connecting to the gradiojuce_client daemon.");
+    return false;
+  }
+
+  // writes one line to the daemon socket. cancel() shares this path from the
+  // message thread while a request is blocked reading, hence the write lock.
+  bool writeDaemonLine(const juce::var& message) const {
+    const juce::ScopedLock lock(m_daemon_write_lock);
+
+    if (m_daemon_socket == nullptr || !m_daemon_socket->isConnected()) {
+      return false;
+    }
+
+    juce::String line = juce::JSON::toString(message, true) + "\n";
+    int numBytes = (int) line.getNumBytesAsUTF8();
+
+    return m_daemon_socket->write(line.toRawUTF8(), numBytes) == numBytes;
+  }
+
+  // sends one request to the daemon (a JSON object on a single line) and
+  // blocks for the matching response line. status event lines pushed by the
+  // helper while the job runs are applied as they arrive. returns nullopt if
+  // the socket broke, so the caller can fall back to a one-shot spawn.
+  // NOTE: callers must hold m_daemon_lock.
+  std::optional<std::pair<juce::String, juce::uint32>> run_daemon_request(const juce::var& request) const {
+    if (!writeDaemonLine(request)) {
+      return std::nullopt;
+    }
+
+    // while we're blocked on the socket, the daemon process is fair game for
+    // cancel()'s hard-kill deadline: killing it fails this read, and the
+    // fallback spawn that triggers sees the cancel flag and exits right away
+    ScopedChildRegistration registration(m_children, &m_daemon_process);
+
+    juce::MemoryOutputStream buffer;
+    char byte = 0;
+
+    while (true) {
+      if (m_daemon_socket->read(&byte, 1, true) != 1) {
+        return std::nullopt;
+      }
+
+      if (byte != '\n') {
+        buffer.writeByte(byte);
+        continue;
+      }
+
+      juce::var response;
+      if (juce::JSON::parse(buffer.toString(), response).failed()) {
+        return std::nullopt;
+      }
+
+      buffer.reset();
+
+      // status and partial-output events are pushed mid-request; the final
+      // response is the only line without a "type"
+      if (response["type"].toString() == "status") {
+        setStatus(response["status"].toString().toStdString());
+        continue;
+      }
+
+      if (response["type"].toString() == "partial") {
+        setPartialOutput(juce::File(response["path"].toString()));
+        continue;
+      }
+
+      juce::String log = response["log"].toString();
+      juce::uint32 exit_code = (juce::uint32) (int) response["exit_code"];
+
+      return std::make_pair(log, exit_code);
+    }
+  }
+
   juce::var loadJsonFromFile(const juce::File& file) const {
     juce::var result;
 
@@ -516,38 +1603,20 @@ private:
     // Create a JSON array to hold each control's value
     juce::Array<juce::var> jsonCtrlsArray;
 
-    // Iterate through each control in m_ctrls
-    for (const auto& ctrlPair : m_ctrls) {
-        auto ctrl = ctrlPair.second;
-
-        // Check the type of ctrl and extract its value
-        if (auto sliderCtrl = dynamic_cast<SliderCtrl*>(ctrl.get())) {
-            // Slider control, use sliderCtrl->value
-            jsonCtrlsArray.add(juce::var(sliderCtrl->value));
-        } else if (auto textBoxCtrl = dynamic_cast<TextBoxCtrl*>(ctrl.get())) {
-            // Text box control, use textBoxCtrl->value
-            jsonCtrlsArray.add(juce::var(textBoxCtrl->value));
-        } else if (auto numberBoxCtrl = dynamic_cast<NumberBoxCtrl*>(ctrl.get())) {
-            // Number box control, use numberBoxCtrl->value
-            jsonCtrlsArray.add(juce::var(numberBoxCtrl->value));
-        } else if (auto toggleCtrl = dynamic_cast<ToggleCtrl*>(ctrl.get())) {
-            // Toggle control, use toggleCtrl->value
-            jsonCtrlsArray.add(juce::var(toggleCtrl->value));
-        } else if (auto comboBoxCtrl = dynamic_cast<ComboBoxCtrl*>(ctrl.get())) {
-            // Combo box control, use comboBoxCtrl->value
-            jsonCtrlsArray.add(juce::var(comboBoxCtrl->value));
-        } else if (auto audioInCtrl = dynamic_cast<AudioInCtrl*>(ctrl.get())) {
-            // Audio in control, use audioInCtrl->value
-            audioInCtrl->value = audioInputPath;
-            jsonCtrlsArray.add(juce::var(audioInCtrl->value));
-        } else if (auto midiInCtrl = dynamic_cast<MidiInCtrl*>(ctrl.get())) {
-            midiInCtrl->value = audioInputPath;
-            jsonCtrlsArray.add(juce::var(midiInCtrl->value));
-        } else {
-            // Unsupported control type or missing implementation
-            LogAndDBG("Unsupported control type or missing implementation for control with ID: " + ctrl->id.toString());
-            return false;
-        }
+    // Iterate through each control in m_ctrls. A single visit over the
+    // contiguous variants resolves each type at compile time - no RTTI,
+    // and the variant is exhaustive so there's no unsupported-type case.
+    for (const auto& ctrl : m_ctrls) {
+        std::visit([&](const auto& c) {
+            using T = std::decay_t<decltype(c)>;
+
+            if constexpr (std::is_same_v<T, AudioInCtrl> || std::is_same_v<T, MidiInCtrl>) {
+                // the main media input: its value is the path we're processing
+                jsonCtrlsArray.add(juce::var(audioInputPath));
+            } else {
+                jsonCtrlsArray.add(juce::var(c.value));
+            }
+        }, ctrl);
     }
 
     // Convert the array to a JSON string
@@ -568,8 +1637,61 @@ private:
   juce::File m_status_flag_file {
     juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("WebModel_STATUS")
   };
+  // the resident helper process and its request socket. mutable because
+  // process() is const but may (re)start the daemon lazily.
+  mutable juce::CriticalSection m_daemon_lock;
+  mutable juce::CriticalSection m_daemon_write_lock;
+  mutable juce::ChildProcess m_daemon_process;
+  mutable std::unique_ptr<juce::StreamingSocket> m_daemon_socket;
+  mutable int m_daemon_port {0};
+
+  // helper processes currently blocked on, registered scope-wise so cancel()
+  // can hard-kill one that ignores the graceful signals. held via shared_ptr
+  // so the deferred killer thread stays safe even if the model is torn down
+  // before its deadline fires.
+  struct ChildProcessRegistry {
+    juce::CriticalSection lock;
+    std::vector<juce::ChildProcess*> children;
+  };
+
+  struct ScopedChildRegistration {
+    ScopedChildRegistration(std::shared_ptr<ChildProcessRegistry> r, juce::ChildProcess* p)
+        : registry(std::move(r)), process(p) {
+      const juce::ScopedLock lock(registry->lock);
+      registry->children.push_back(process);
+    }
+
+    ~ScopedChildRegistration() {
+      const juce::ScopedLock lock(registry->lock);
+      registry->children.erase(
+          std::remove(registry->children.begin(), registry->children.end(), process),
+          registry->children.end());
+    }
+
+    std::shared_ptr<ChildProcessRegistry> registry;
+    juce::ChildProcess* process;
+  };
+
+  std::shared_ptr<ChildProcessRegistry> m_children { std::make_shared<ChildProcessRegistry>() };
+
+  // how long cancel() gives the graceful path before hard-killing
+  static constexpr int cancelKillDeadlineMs = 2000;
+
+  // how much helper stdout run_command keeps around for error matching
+  static constexpr int maxRetainedOutputChars = 256 * 1024;
+
+  // status pushed over the daemon socket; empty means "read the flag file"
+  mutable juce::CriticalSection m_status_lock;
+  mutable std::string m_status;
+  mutable juce::ChangeBroadcaster m_statusBroadcaster;
+
+  // latest partial output pushed over the daemon socket
+  mutable juce::CriticalSection m_partial_lock;
+  mutable juce::File m_partial_file;
+  mutable juce::ChangeBroadcaster m_partialBroadcaster;
+
   CtrlList m_ctrls;
-  std::unique_ptr<juce::FileLogger> m_logger {nullptr};
+  std::unique_ptr<AsyncLogger> m_logger {nullptr};
 
   string m_url;
   string prefix_cmd;
@@ -577,14 +1699,32 @@ private:
 };
 
 
-// a timer that checks the status of the model and broadcasts a change if if there is one
+// relays model status changes to the UI. updates normally arrive pushed over
+// the daemon socket (via WebModel::statusBroadcaster()), so they're broadcast
+// the moment they happen; the timer only remains as a slow fallback for the
+// one-shot spawn path, which still reports through the status flag file.
 class ModelStatusTimer : public juce::Timer,
-                         public juce::ChangeBroadcaster {
+                         public juce::ChangeBroadcaster,
+                         private juce::ChangeListener {
 public:
   ModelStatusTimer(std::shared_ptr<WebModel> model) : m_model(model) {
+    m_model->statusBroadcaster().addChangeListener(this);
+  }
+
+  ~ModelStatusTimer() override {
+    m_model->statusBroadcaster().removeChangeListener(this);
   }
 
   void timerCallback() override {
+    update();
+  }
+
+private:
+  void changeListenerCallback(juce::ChangeBroadcaster*) override {
+    update();
+  }
+
+  void update() {
     // get the status of the model
     std::string status = m_model->getStatus();
 
@@ -595,7 +1735,6 @@ public:
     }
   }
 
-private:
   std::shared_ptr<WebModel> m_model;
   std::string m_last_status;
 };
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <memory>
+
 #include <juce_audio_utils/juce_audio_utils.h>
 
+#include "AudioPlaybackEngine.h"
 #include "MediaDisplayComponent.h"
 
 
@@ -11,33 +15,42 @@ public:
 
     AudioDisplayComponent()
     {
-        thread.startThread(Thread::Priority::normal);
-
-        formatManager.registerBasicFormats();
-
-        deviceManager.initialise(0, 2, nullptr, true, {}, nullptr);
-        deviceManager.addAudioCallback(&sourcePlayer);
-
-        sourcePlayer.setSource(&transportSource);
-
-        thumbnail.addChangeListener(this);
+        // NOTE: nothing heavy happens here. format registration and the
+        // preview thread are deferred to the first file load, and the shared
+        // engine only opens the audio device once something actually plays -
+        // so constructing the display during startup costs nothing.
+
+        // playback goes through the shared engine - attaching a source never
+        // touches the audio device itself
+        audioEngine->attach(&transportSource);
+
+        // min/max pyramid, finest to coarsest - drawMainArea picks the level
+        // matching the current zoom
+        mipLevels[0] = std::make_unique<WaveformMipLevel>(128, formatManager);
+        mipLevels[1] = std::make_unique<WaveformMipLevel>(512, formatManager);
+        mipLevels[2] = std::make_unique<WaveformMipLevel>(2048, formatManager);
+
+        for (auto& level : mipLevels) {
+            level->thumbnail.addChangeListener(this);
+        }
 
         mediaHandlerInstructions = "Audio waveform.\nClick and drag to start playback from any point in the waveform\nVertical scroll to zoom in/out.\nHorizontal scroll to move the waveform.";
     }
 
     ~AudioDisplayComponent()
     {
-        deviceManager.removeAudioCallback(&sourcePlayer);
+        audioEngine->detach(&transportSource);
 
         transportSource.setSource(nullptr);
-        sourcePlayer.setSource(nullptr);
 
-        thumbnail.removeChangeListener(this);
+        for (auto& level : mipLevels) {
+            level->thumbnail.removeChangeListener(this);
+        }
     }
 
     void drawMainArea(Graphics& g, Rectangle<int>& a) override
     {
-        thumbnail.drawChannels(g, a, visibleRange.getStart(), visibleRange.getEnd(), 1.0f);
+        getThumbnailForWidth(a.getWidth()).drawChannels(g, a, visibleRange.getStart(), visibleRange.getEnd(), 1.0f);
     }
 
     static StringArray getSupportedExtensions()
@@ -62,10 +75,37 @@ public:
 
     void loadMediaFile(const URL& filePath) override
     {
+        ensureFormatsReady();
+
         const auto source = std::make_unique<URLInputSource>(filePath);
 
         File audioFile = filePath.getLocalFile();
 
+        // very large files get memory-mapped where the format supports it:
+        // seeks become page-cache reads with zero copy, instead of the
+        // buffered stream chewing through the file on the preview thread
+        if (audioFile.getSize() >= memoryMapThresholdBytes) {
+            if (auto* format = formatManager.findFormatForFileExtension(audioFile.getFileExtension())) {
+                std::unique_ptr<MemoryMappedAudioFormatReader> mappedReader(format->createMemoryMappedReader(audioFile));
+
+                if (mappedReader != nullptr && mappedReader->mapEntireFile()) {
+                    DBG("AudioDisplayComponent::loadMediaFile: Memory-mapped " << audioFile.getFullPathName() << ".");
+
+                    sourceSampleRate = mappedReader->sampleRate;
+
+                    audioFileSource = std::make_unique<AudioFormatReaderSource>(mappedReader.release(), true);
+
+                    // mapped reads need no read-ahead thread or buffering
+                    transportSource.setSource(audioFileSource.get(), 0, nullptr,
+                                              audioFileSource->getAudioFormatReader()->sampleRate);
+                    return;
+                }
+
+                // the format can't be mapped (or mapping failed) - fall
+                // through to the buffered stream path
+            }
+        }
+
         if (source == nullptr) {
             DBG("AudioDisplayComponent::loadMediaFile: File " << audioFile.getFullPathName() << " does not exist.");
             // TODO - better error handing
@@ -91,6 +131,8 @@ public:
             return;
         }
 
+        sourceSampleRate = reader->sampleRate;
+
         audioFileSource = std::make_unique<AudioFormatReaderSource>(reader.release(), true);
 
         // ..and plug it into our transport source
@@ -107,6 +149,9 @@ public:
 
     void startPlaying() override
     {
+        // a no-op when the background pre-warm already opened the device
+        audioEngine->ensureInitialised();
+
         // TODO - clear displayed audio buffer upon start here?
         transportSource.start();
     }
@@ -120,11 +165,69 @@ public:
 
     double getTotalLengthInSecs() override
     {
-        return thumbnail.getTotalLength();
+        return mipLevels[1]->thumbnail.getTotalLength();
     }
 
 private:
 
+    // one level of the waveform pyramid. each level owns its cache because
+    // AudioThumbnailCache keys entries by source hash alone - levels at
+    // different resolutions would otherwise overwrite each other.
+    struct WaveformMipLevel
+    {
+        WaveformMipLevel(int res, AudioFormatManager& fm)
+            : resolution(res), thumbnail(res, fm, cache) {}
+
+        const int resolution;
+
+        // large enough to keep every step of a typical undo chain resident
+        AudioThumbnailCache cache{ 64 };
+
+        AudioThumbnail thumbnail;
+
+        // where to persist the thumbnail once the in-progress scan finishes
+        File pendingCacheFile;
+    };
+
+    // registers the audio formats and starts the preview read-ahead thread
+    // the first time a file actually needs them, keeping them off the
+    // startup path. only ever called from the message thread.
+    void ensureFormatsReady()
+    {
+        if (formatsReady) {
+            return;
+        }
+
+        formatManager.registerBasicFormats();
+        thread.startThread(Thread::Priority::normal);
+
+        formatsReady = true;
+    }
+
+    // picks the coarsest pyramid level that still provides at least one
+    // min/max sample per pixel for the visible range, so neither drawing
+    // nor aggregation cost blows up at extreme zooms
+    AudioThumbnail& getThumbnailForWidth(int widthInPixels)
+    {
+        double samplesPerPixel = visibleRange.getLength() * sourceSampleRate / jmax(1, widthInPixels);
+
+        size_t chosen = 0;
+
+        for (size_t levelIdx = 0; levelIdx < mipLevels.size(); ++levelIdx) {
+            if (mipLevels[levelIdx]->resolution <= samplesPerPixel) {
+                chosen = levelIdx;
+            }
+        }
+
+        // if the ideal level is still scanning, the persisted default level
+        // is better than a partial waveform
+        if (!mipLevels[chosen]->thumbnail.isFullyLoaded() && mipLevels[1]->thumbnail.isFullyLoaded()) {
+            chosen = 1;
+        }
+
+        return mipLevels[chosen]->thumbnail;
+    }
+
     void resetDisplay() override
     {
         transportSource.stop();
@@ -132,28 +235,94 @@ private:
 
         audioFileSource.reset();
 
-        thumbnail.clear();
+        for (auto& level : mipLevels) {
+            level->thumbnail.clear();
+        }
+    }
+
+    void changeListenerCallback(ChangeBroadcaster* source) override
+    {
+        MediaDisplayComponent::changeListenerCallback(source);
+
+        // once a fresh scan completes, persist the thumbnail so the next
+        // load of this file paints instantly
+        for (auto& level : mipLevels) {
+            if (level->pendingCacheFile != File() && level->thumbnail.isFullyLoaded()) {
+                level->pendingCacheFile.deleteFile();
+
+                FileOutputStream stream(level->pendingCacheFile);
+
+                if (stream.openedOk()) {
+                    level->thumbnail.saveTo(stream);
+                }
+
+                level->pendingCacheFile = File();
+            }
+        }
     }
 
     void postLoadActions(const URL& filePath) override
     {
-        if (auto inputSource = std::make_unique<URLInputSource>(filePath)) {
-            thumbnailCache.clear();
-            thumbnail.setSource(inputSource.release());
+        File audioFile = filePath.getLocalFile();
+
+        for (auto& level : mipLevels) {
+            level->pendingCacheFile = File();
+
+            File cacheFile = getThumbnailCacheFile(audioFile, level->resolution);
+
+            // reload a previously computed thumbnail from the on-disk cache
+            // if we have one - no rescan of the audio data at all
+            if (cacheFile.existsAsFile()) {
+                FileInputStream stream(cacheFile);
+
+                if (stream.openedOk() && level->thumbnail.loadFrom(stream)) {
+                    continue;
+                }
+            }
+
+            if (auto inputSource = std::make_unique<URLInputSource>(filePath)) {
+                // NOTE: the in-memory caches are deliberately NOT cleared here,
+                // so hopping through the undo chain reuses scanned thumbnails
+                level->thumbnail.setSource(inputSource.release());
+                level->pendingCacheFile = cacheFile;
+            }
         }
+
+        repaint();
+    }
+
+    // on-disk location for a file's serialized thumbnail. keyed on path,
+    // size, mtime and pyramid resolution, so an edited file never reuses a
+    // stale thumbnail.
+    static File getThumbnailCacheFile(const File& audioFile, int resolution)
+    {
+        File cacheDir = File::getSpecialLocation(File::userApplicationDataDirectory)
+            .getChildFile("HARP").getChildFile("thumbnail_cache");
+        cacheDir.createDirectory();
+
+        String key = audioFile.getFullPathName()
+            + "|" + String(audioFile.getSize())
+            + "|" + String(audioFile.getLastModificationTime().toMilliseconds())
+            + "|" + String(resolution);
+
+        return cacheDir.getChildFile(String::toHexString(key.hashCode64()) + ".thumb");
     }
 
     TimeSliceThread thread{ "audio file preview" };
-    
+
     AudioFormatManager formatManager;
-    AudioDeviceManager deviceManager;
+    bool formatsReady = false;
+
+    SharedResourcePointer<AudioPlaybackEngine> audioEngine;
 
     std::unique_ptr<AudioFormatReaderSource> audioFileSource;
 
-    AudioSourcePlayer sourcePlayer;
     AudioTransportSource transportSource;
 
-    AudioThumbnailCache thumbnailCache{ 5 };
+    std::array<std::unique_ptr<WaveformMipLevel>, 3> mipLevels;
+
+    double sourceSampleRate = 44100.0;
 
-    AudioThumbnail thumbnail = AudioThumbnail(512, formatManager, thumbnailCache);
+    // files at or above this size play through a memory-mapped reader
+    static constexpr int64 memoryMapThresholdBytes = 256 * 1024 * 1024;
 };
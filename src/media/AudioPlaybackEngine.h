@@ -0,0 +1,82 @@
+#pragma once
+
+#include <juce_audio_utils/juce_audio_utils.h>
+
+using namespace juce;
+
+
+// Process-wide playback service: one AudioDeviceManager and one
+// AudioSourcePlayer for the whole app, with playback sources attached
+// through a mixer. Hold it via SharedResourcePointer<AudioPlaybackEngine> -
+// MainComponent keeps one alive for the session, so swapping between audio
+// and MIDI displays or reloading a file never reopens the device (which
+// costs hundreds of milliseconds on WASAPI and can glitch other apps).
+//
+// Construction is free: the device itself is only opened by
+// ensureInitialised(), so building the engine at startup doesn't delay the
+// window. MainComponent pre-warms it on a background thread right after the
+// UI is up, and startPlaying() calls ensureInitialised() as a backstop.
+class AudioPlaybackEngine
+{
+public:
+
+    AudioPlaybackEngine() = default;
+
+    ~AudioPlaybackEngine()
+    {
+        const ScopedLock lock(initLock);
+
+        if (initialised) {
+            deviceManager.removeAudioCallback(&sourcePlayer);
+            sourcePlayer.setSource(nullptr);
+        }
+
+        mixer.removeAllInputs();
+    }
+
+    // opens the default output device and hooks the mixer up to it. safe to
+    // call from any thread and from several threads at once; every call
+    // after the first is a cheap no-op.
+    void ensureInitialised()
+    {
+        const ScopedLock lock(initLock);
+
+        if (initialised) {
+            return;
+        }
+
+        deviceManager.initialise(0, 2, nullptr, true, {}, nullptr);
+        deviceManager.addAudioCallback(&sourcePlayer);
+
+        sourcePlayer.setSource(&mixer);
+
+        initialised = true;
+    }
+
+    // kicks the device open on a background thread, so the first call to
+    // startPlaying() finds it already running instead of paying the
+    // device-open cost on the message thread
+    void warmUpAsync()
+    {
+        Thread::launch([this] { ensureInitialised(); });
+    }
+
+    // attach/detach are safe while audio is running (the mixer does its own
+    // locking), and never touch the device themselves - an attached source
+    // just sits silent in the mixer until the engine is initialised. the
+    // engine never takes ownership of the source.
+    void attach(AudioSource* source) { mixer.addInputSource(source, false); }
+
+    void detach(AudioSource* source) { mixer.removeInputSource(source); }
+
+    AudioDeviceManager& getDeviceManager() { return deviceManager; }
+
+private:
+
+    CriticalSection initLock;
+    bool initialised = false;
+
+    AudioDeviceManager deviceManager;
+    AudioSourcePlayer sourcePlayer;
+    MixerAudioSource mixer;
+};
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <filesystem>
+
 #include "juce_core/juce_core.h"
+#include "juce_opengl/juce_opengl.h"
+
+#include "../Trace.h"
 
 using namespace juce;
 
@@ -18,6 +23,23 @@ public:
     {
         resetPaths();
 
+        // the main area (waveform / note grid) only changes on load, zoom or
+        // scroll - cache our own paint() into an image so the 40 Hz cursor
+        // updates composite the cached layer instead of re-running
+        // drawChannels() on every frame
+        setBufferedToImage(true);
+
+        // GPU compositing (optional): attaching a GL context makes that
+        // cached layer live as a texture and playback-time work collapse to
+        // cursor-quad updates. purely a compositing swap - all paint() code
+        // is untouched - so HARP_NO_OPENGL=1 drops back to the software
+        // renderer on machines with broken drivers.
+        if (SystemStats::getEnvironmentVariable("HARP_NO_OPENGL", "") != "1") {
+            openGLContext.setComponentPaintingEnabled(true);
+            openGLContext.setContinuousRepainting(false);
+            openGLContext.attachTo(*this);
+        }
+
         addChildComponent(horizontalScrollBar);
         horizontalScrollBar.setAutoHide(false);
         horizontalScrollBar.addListener(this);
@@ -28,6 +50,8 @@ public:
 
     ~MediaDisplayComponent()
     {
+        openGLContext.detach();
+
         horizontalScrollBar.removeListener(this);
     }
 
@@ -87,6 +111,8 @@ public:
 
     void updateDisplay(const URL& filePath)
     {
+        HARP_TRACE("media.update_display");
+
         resetDisplay();
 
         loadMediaFile(filePath);
@@ -128,12 +154,34 @@ public:
 
         tempFile.getParentDirectory().createDirectory();
 
-        if (!targetFile.copyFileTo(tempFile)) {
-            DBG("MediaDisplayComponent::generateTempFile: Failed to copy file " << targetFile.getFullPathName() << " to " << tempFile.getFullPathName() << ".");
+        bool preserved = false;
 
-            AlertWindow("Error", "Failed to create temporary file for processing.", AlertWindow::WarningIcon);
-        } else {
-            DBG("MediaDisplayComponent::generateTempFile: Copied file " << targetFile.getFullPathName() << " to " << tempFile.getFullPathName() << ".");
+        if (numTempFiles > 0) {
+            // later version steps just hard-link the previous one where the
+            // filesystem supports it - O(1) metadata work instead of a full
+            // data copy. processing replaces the link via a rename, so the
+            // previous version keeps its own data (file-level copy-on-write).
+            // the first version is always a real copy, so in-place writes to
+            // the original file (e.g. saving) can never reach into the chain.
+            std::error_code ec;
+            std::filesystem::create_hard_link(targetFile.getFullPathName().toStdString(),
+                                              tempFile.getFullPathName().toStdString(), ec);
+
+            preserved = !ec;
+
+            if (preserved) {
+                DBG("MediaDisplayComponent::generateTempFile: Linked file " << targetFile.getFullPathName() << " to " << tempFile.getFullPathName() << ".");
+            }
+        }
+
+        if (!preserved) {
+            if (!targetFile.copyFileTo(tempFile)) {
+                DBG("MediaDisplayComponent::generateTempFile: Failed to copy file " << targetFile.getFullPathName() << " to " << tempFile.getFullPathName() << ".");
+
+                AlertWindow("Error", "Failed to create temporary file for processing.", AlertWindow::WarningIcon);
+            } else {
+                DBG("MediaDisplayComponent::generateTempFile: Copied file " << targetFile.getFullPathName() << " to " << tempFile.getFullPathName() << ".");
+            }
         }
 
         tempFilePaths.add(tempFilePath);
@@ -145,6 +193,44 @@ public:
         return tempFilePaths.getReference(currentTempFileIdx);
     }
 
+    // the undo chain, for the session snapshot
+    Array<URL> getTempFilePaths() { return tempFilePaths; }
+
+    int getCurrentTempFileIdx() { return currentTempFileIdx; }
+
+    // puts a previous session's target and undo chain back in place without
+    // generating a fresh temp file the way setupDisplay would. refuses (and
+    // changes nothing) if any file in the chain has gone missing.
+    bool restoreMediaState(const URL& targetPath, const Array<URL>& chain, int chainIdx)
+    {
+        if (chain.isEmpty() || chainIdx < 0 || chainIdx >= chain.size()) {
+            return false;
+        }
+
+        if (!targetPath.getLocalFile().existsAsFile()) {
+            return false;
+        }
+
+        for (const auto& path : chain) {
+            if (!path.getLocalFile().existsAsFile()) {
+                return false;
+            }
+        }
+
+        resetMedia();
+
+        targetFilePath = targetPath;
+        tempFilePaths = chain;
+        currentTempFileIdx = chainIdx;
+
+        updateDisplay(getTempFilePath());
+
+        horizontalScrollBar.setVisible(true);
+        updateVisibleRange({0.0, getTotalLengthInSecs()});
+
+        return true;
+    }
+
     bool iteratePreviousTempFile()
     {
         if (currentTempFileIdx > 0) {
@@ -191,15 +277,36 @@ public:
 
         File backupFile = File(parentDirectory + "/" + targetFileName + "_BACKUP" + targetFileExtension);
 
-        if (targetFile.copyFileTo(backupFile)) {
+        // back the old version up via a hard link where the filesystem
+        // supports it - O(1) metadata work instead of a full traversal of
+        // the old data. the rename below gives the target a fresh inode, so
+        // the backup keeps the old bytes to itself.
+        backupFile.deleteFile();
+
+        std::error_code ec;
+        std::filesystem::create_hard_link(targetFile.getFullPathName().toStdString(),
+                                          backupFile.getFullPathName().toStdString(), ec);
+
+        if (!ec) {
+            DBG("MediaDisplayComponent::overwriteTarget: Linked backup of file " << targetFile.getFullPathName() << " at "  << backupFile.getFullPathName() << ".");
+        } else if (targetFile.copyFileTo(backupFile)) {
             DBG("MediaDisplayComponent::overwriteTarget: Created backup of file" << targetFile.getFullPathName() << " at "  << backupFile.getFullPathName() << ".");
         } else {
             DBG("MediaDisplayComponent::overwriteTarget: Failed to create backup of file" << targetFile.getFullPathName() << " at "  << backupFile.getFullPathName() << ".");
         }
 
-        if (tempFile.copyFileTo(targetFile)) {
+        // stage a copy of the temp version next to the target, then rename
+        // it into place: the target is never in a half-written state - a
+        // crash mid-save leaves either the old file or the new one, whole.
+        // (the temp version itself must stay put; it's part of the undo
+        // chain, so it can't simply be renamed over.)
+        File stagingFile = File(parentDirectory + "/" + targetFileName + "_STAGING" + targetFileExtension);
+        stagingFile.deleteFile();
+
+        if (tempFile.copyFileTo(stagingFile) && stagingFile.moveFileTo(targetFile)) {
             DBG("MediaDisplayComponent::overwriteTarget: Overwriting file " << targetFile.getFullPathName() << " with " << tempFile.getFullPathName() << ".");
         } else {
+            stagingFile.deleteFile();
             DBG("MediaDisplayComponent::overwriteTarget: Failed to overwrite file " << targetFile.getFullPathName() << " with " << tempFile.getFullPathName() << ".");
         }
     }
@@ -208,19 +315,24 @@ public:
 
     void filesDropped(const StringArray& files, int /*x*/, int /*y*/) override
     {
-        // TODO - warning or handling for additional files
+        droppedFilePaths.clear();
+
+        for (auto& file : files) {
+            droppedFilePaths.add(URL(File(file)));
+        }
 
-        droppedFilePath = URL(File(files[0]));
         sendChangeMessage();
     }
 
-    URL getDroppedFilePath() { return droppedFilePath; }
+    URL getDroppedFilePath() { return droppedFilePaths.isEmpty() ? URL() : droppedFilePaths.getReference(0); }
+
+    Array<URL> getDroppedFilePaths() { return droppedFilePaths; }
 
-    bool isFileDropped() { return !droppedFilePath.isEmpty(); }
+    bool isFileDropped() { return !droppedFilePaths.isEmpty(); }
 
     void clearDroppedFile()
     {
-        droppedFilePath = URL();
+        droppedFilePaths.clear();
     }
 
     virtual void setPlaybackPosition(double t) = 0;
@@ -359,7 +471,11 @@ private:
     {
         if (isPlaying()) {
             //updateVisibleRange(visibleRange.movedToStartAt(getPlaybackPosition() - (visibleRange.getLength() / 2.0f)));
-            updateVisibleRange(visibleRange);
+
+            // only the cursor moves from frame to frame - repositioning the
+            // marker child repaints just its old and new rects, not the
+            // whole waveform
+            updateCursorPosition();
         } else {
             stop();
             sendChangeMessage();
@@ -422,7 +538,7 @@ private:
     }
 
     URL targetFilePath;
-    URL droppedFilePath;
+    Array<URL> droppedFilePaths;
 
     int currentTempFileIdx;
     Array<URL> tempFilePaths;
@@ -430,5 +546,7 @@ private:
     const float cursorWidth = 1.5f;
     DrawableRectangle currentPositionMarker;
 
+    OpenGLContext openGLContext;
+
     double currentHorizontalZoomFactor;
 };
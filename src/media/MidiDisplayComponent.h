@@ -1,7 +1,12 @@
 #pragma once
 
+#include <array>
+#include <vector>
+
 #include "../pianoroll/PianoRollComponent.hpp"
+#include "AudioPlaybackEngine.h"
 #include "MediaDisplayComponent.h"
+#include "MidiPlaybackSource.h"
 
 
 class MidiDisplayComponent : public MediaDisplayComponent
@@ -12,10 +17,17 @@ public:
     {
         addAndMakeVisible(pianoRoll);
 
+        // audition playback goes through the same shared engine as the
+        // audio display - attaching the source never touches the device
+        audioEngine->attach(&midiSource);
+
         mediaHandlerInstructions = "MIDI pianoroll.\nClick and drag to start playback from any point in the pianoroll\nVertical scroll to zoom in/out.\nHorizontal scroll to move the pianoroll.";
     }
 
-    ~MidiDisplayComponent() {}
+    ~MidiDisplayComponent()
+    {
+        audioEngine->detach(&midiSource);
+    }
 
     void drawMainArea(Graphics& g, Rectangle<int>& a) override
     {
@@ -68,79 +80,79 @@ public:
 
         pianoRoll.resizeNoteGrid(totalLengthInSecs);
 
-        for (int trackIdx = 0; trackIdx < midiFile.getNumTracks(); ++trackIdx) {
-            const juce::MidiMessageSequence* constTrack = midiFile.getTrack(trackIdx);
+        std::vector<MidiNote> notes;
 
-            if (constTrack != nullptr) {
-                juce::MidiMessageSequence track(*constTrack);
-                track.updateMatchedPairs();
-
-                DBG("Track " << trackIdx << " has " << track.getNumEvents() << " events.");
-
-                for (int eventIdx = 0; eventIdx < track.getNumEvents(); ++eventIdx) {
-                    const auto midiEvent = track.getEventPointer(eventIdx);
-                    const auto& midiMessage = midiEvent->message;
+        for (int trackIdx = 0; trackIdx < midiFile.getNumTracks(); ++trackIdx) {
+            const juce::MidiMessageSequence* track = midiFile.getTrack(trackIdx);
 
-                    double startTime = midiEvent->message.getTimeStamp();
+            if (track == nullptr) {
+                continue;
+            }
 
-                    DBG("Event " << eventIdx << " at " << startTime << ": " << midiMessage.getDescription());
+            DBG("Track " << trackIdx << " has " << track->getNumEvents() << " events.");
 
-                    if (midiMessage.isNoteOn()) {
-                        int noteNumber = midiMessage.getNoteNumber();
-                        int velocity = midiMessage.getVelocity();
+            // Pair note ons with their note offs in a single pass, keeping a
+            // stack of pending onsets per pitch
+            std::array<std::vector<std::pair<double, unsigned char>>, 128> pendingOnsets;
 
-                        double duration = 0;
+            for (int eventIdx = 0; eventIdx < track->getNumEvents(); ++eventIdx) {
+                const auto& midiMessage = track->getEventPointer(eventIdx)->message;
 
-                        for (int offIdx = eventIdx + 1; offIdx < track.getNumEvents(); ++offIdx) {
-                            const auto offEvent = track.getEventPointer(offIdx);
+                if (midiMessage.isNoteOn()) {
+                    pendingOnsets[midiMessage.getNoteNumber()].push_back(
+                        {midiMessage.getTimeStamp(), (unsigned char) midiMessage.getVelocity()});
+                } else if (midiMessage.isNoteOff()) {
+                    auto& onsets = pendingOnsets[midiMessage.getNoteNumber()];
 
-                            // Find the matching note off event
-                            if (offEvent->message.isNoteOff() && offEvent->message.getNoteNumber() == noteNumber) {
-                                duration = (offEvent->message.getTimeStamp() - midiEvent->message.getTimeStamp());
-                                break;
-                            }
-                        }
+                    if (!onsets.empty()) {
+                        // Offs match the earliest pending onset for the pitch
+                        auto [startTime, velocity] = onsets.front();
+                        onsets.erase(onsets.begin());
 
-                        // Create a component for each for each note
-                        MidiNoteComponent n = MidiNoteComponent(noteNumber, velocity, startTime, duration);
-                        pianoRoll.insertNote(n);
+                        notes.push_back({(unsigned char) midiMessage.getNoteNumber(), velocity,
+                                         startTime, midiMessage.getTimeStamp() - startTime});
                     }
                 }
             }
+
+            // Onsets that never saw an off get zero duration
+            for (int noteNumber = 0; noteNumber < 128; ++noteNumber) {
+                for (const auto& [startTime, velocity] : pendingOnsets[noteNumber]) {
+                    notes.push_back({(unsigned char) noteNumber, velocity, startTime, 0.0});
+                }
+            }
         }
-    }
 
-    void setPlaybackPosition(double t) override
-    {
-        // TODO
-    }
+        DBG("Loaded " << (int) notes.size() << " notes from MIDI file.");
 
-    double getPlaybackPosition() override
-    {
-        // TODO
-        return 0.0;
+        midiSource.setNotes(notes);
+
+        pianoRoll.setNotes(std::move(notes));
     }
 
+    void setPlaybackPosition(double t) override { midiSource.setPosition(t); }
+
+    double getPlaybackPosition() override { return midiSource.getPosition(); }
+
     void startPlaying() override
     {
-        // TODO
-        AlertWindow::showMessageBoxAsync(
-            AlertWindow::WarningIcon,
-            "NotImplementedError",
-            "MIDI playback has not yet been implemented."
-        );
+        // a no-op when the background pre-warm already opened the device
+        audioEngine->ensureInitialised();
+
+        // starting from (or past) the end means starting over
+        if (midiSource.getPosition() >= totalLengthInSecs) {
+            midiSource.setPosition(0.0);
+        }
+
+        midiSource.start();
     }
 
     void stopPlaying() override
     {
-        // TODO
+        midiSource.stop();
     }
 
-    bool isPlaying() override
-    {
-        // TODO
-        return false;
-    }
+    bool isPlaying() override { return midiSource.isPlaying(); }
 
     double getTotalLengthInSecs() override
     {
@@ -156,26 +168,49 @@ public:
 
 private:
 
+    // unlike the audio display, only the note grid (right of the keyboard)
+    // maps to media time, so the keyboard offset has to be accounted for
+
     double xToTime(const float x) const override
     {
-        // TODO
-        return 0.0;
+        float gridX = x - (float) (pianoRoll.getX() + pianoRoll.getKeyboardWidth() + 5);
+        float gridWidth = (float) pianoRoll.getPianoRollWidth();
+
+        if (gridWidth <= 0) {
+            return 0.0;
+        }
+
+        return (gridX / gridWidth) * visibleRange.getLength() + visibleRange.getStart();
     }
 
     float timeToX(const double t) const override
     {
-        // TODO
-        return 0.0f;
+        float gridStart = (float) (pianoRoll.getX() + pianoRoll.getKeyboardWidth() + 5);
+
+        auto totalLength = visibleRange.getLength();
+
+        if (totalLength <= 0) {
+            return gridStart;
+        }
+
+        return gridStart + (float) (((t - visibleRange.getStart()) / totalLength) * pianoRoll.getPianoRollWidth());
     }
 
     void resetDisplay() override
     {
+        midiSource.stop();
+        midiSource.clearNotes();
+
         pianoRoll.resetNotes();
         pianoRoll.resizeNoteGrid(0.0);
     }
 
     void postLoadActions(const URL& filePath) override {}
 
+    SharedResourcePointer<AudioPlaybackEngine> audioEngine;
+
+    MidiPlaybackSource midiSource;
+
     PianoRollComponent pianoRoll{70, scrollBarSize, scrollBarSpacing};
 
     double totalLengthInSecs;
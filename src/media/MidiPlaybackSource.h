@@ -0,0 +1,346 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <juce_audio_utils/juce_audio_utils.h>
+
+#include "../pianoroll/NoteGridComponent.hpp"
+
+using namespace juce;
+
+
+// Renders the piano roll's notes as audio so model output can be auditioned.
+// Built for the render callback: the notes become a flat, pre-sorted on/off
+// event buffer dispatched sample-accurately against the playhead, transport
+// commands travel from the UI thread through a lock-free FIFO, and a fixed
+// voice pool of simple sine voices means no allocation ever happens while
+// rendering. The event buffer itself is swapped under a try-lock - if the UI
+// is mid-swap the callback stays silent for that one block, the same
+// discipline MixerAudioSource applies further up this chain.
+//
+// Attach it to the shared AudioPlaybackEngine like any other source.
+class MidiPlaybackSource : public AudioSource
+{
+public:
+
+    // replaces the scheduled notes. call from the message thread.
+    void setNotes(const std::vector<MidiNote>& notes)
+    {
+        std::vector<NoteEvent> fresh;
+        fresh.reserve(notes.size() * 2);
+
+        for (const auto& note : notes) {
+            fresh.push_back({note.startTime, note.noteNumber, note.velocity, true});
+            // zero-duration notes (unterminated onsets) still get a short sound
+            fresh.push_back({note.startTime + jmax(note.duration, minNoteLengthSecs), note.noteNumber, 0, false});
+        }
+
+        std::sort(fresh.begin(), fresh.end(),
+                  [](const NoteEvent& a, const NoteEvent& b) { return a.time < b.time; });
+
+        const ScopedLock lock(eventLock);
+
+        events.swap(fresh);
+        lastEventTime = events.empty() ? 0.0 : events.back().time;
+        eventsChanged = true;
+    }
+
+    void clearNotes() { setNotes({}); }
+
+    // --- transport, callable from the UI thread ---
+
+    void start()
+    {
+        // optimistic, so isPlaying() is true before the next audio block
+        playing.store(true);
+        pushCommand({Command::Type::play, 0.0});
+    }
+
+    void stop()
+    {
+        playing.store(false);
+        pushCommand({Command::Type::stop, 0.0});
+    }
+
+    void setPosition(double seconds)
+    {
+        // published immediately so the cursor follows a drag even before
+        // (or without) the audio thread picking the seek up
+        positionSecs.store(seconds);
+        pushCommand({Command::Type::seek, seconds});
+    }
+
+    bool isPlaying() const { return playing.load(); }
+
+    double getPosition() const { return positionSecs.load(); }
+
+    // --- AudioSource ---
+
+    void prepareToPlay(int /*samplesPerBlockExpected*/, double newSampleRate) override
+    {
+        sampleRate = newSampleRate;
+    }
+
+    void releaseResources() override {}
+
+    void getNextAudioBlock(const AudioSourceChannelInfo& info) override
+    {
+        info.clearActiveBufferRegion();
+
+        drainCommands();
+
+        const ScopedTryLock tryLock(eventLock);
+
+        if (!tryLock.isLocked()) {
+            return; // the UI is swapping the event buffer; silence for one block
+        }
+
+        if (eventsChanged) {
+            relocateNextEvent();
+            eventsChanged = false;
+        }
+
+        if (playing.load()) {
+            int offset = 0;
+
+            while (offset < info.numSamples) {
+                // dispatch everything due at the current playhead...
+                while (nextEventIdx < events.size()
+                       && (int64) (events[nextEventIdx].time * sampleRate) <= playheadSamples) {
+                    const auto& event = events[nextEventIdx++];
+
+                    if (event.isNoteOn) {
+                        noteOn(event.noteNumber, event.velocity);
+                    } else {
+                        noteOff(event.noteNumber);
+                    }
+                }
+
+                // ...then render up to the next event (or the block end)
+                int64 nextEventSample = (nextEventIdx < events.size())
+                    ? (int64) (events[nextEventIdx].time * sampleRate)
+                    : std::numeric_limits<int64>::max();
+
+                int run = (int) jmin((int64) (info.numSamples - offset),
+                                     jmax((int64) 1, nextEventSample - playheadSamples));
+
+                renderVoices(*info.buffer, info.startSample + offset, run);
+
+                offset += run;
+                playheadSamples += run;
+            }
+
+            positionSecs.store(playheadSamples / sampleRate);
+
+            // past the last event with every voice silent means we're done
+            if (nextEventIdx >= events.size() && countActiveVoices() == 0
+                && playheadSamples >= (int64) (lastEventTime * sampleRate)) {
+                playing.store(false);
+            }
+        } else {
+            // keep rendering released voices so stopping doesn't click
+            renderVoices(*info.buffer, info.startSample, info.numSamples);
+        }
+
+        // the voices render mono into channel 0; mirror to the others
+        for (int ch = 1; ch < info.buffer->getNumChannels(); ++ch) {
+            info.buffer->copyFrom(ch, info.startSample, *info.buffer, 0, info.startSample, info.numSamples);
+        }
+    }
+
+private:
+
+    struct NoteEvent {
+        double time;
+        unsigned char noteNumber;
+        unsigned char velocity;
+        bool isNoteOn;
+    };
+
+    struct Command {
+        enum class Type { play, stop, seek };
+
+        Type type;
+        double seekTime;
+    };
+
+    struct Voice {
+        int note = -1; // -1 means free
+        double phase = 0.0;
+        double phaseInc = 0.0;
+        float gain = 0.0f;
+        float level = 0.0f;       // current envelope value
+        float targetLevel = 0.0f; // 1 while held, 0 once released
+    };
+
+    void pushCommand(const Command& command)
+    {
+        int start1, size1, start2, size2;
+        commandFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 > 0) {
+            commands[(size_t) start1] = command;
+            commandFifo.finishedWrite(1);
+        }
+        // a full FIFO just drops the command - the atomics above already
+        // carry the state the UI cares about
+    }
+
+    void drainCommands()
+    {
+        int start1, size1, start2, size2;
+        commandFifo.prepareToRead(commandFifo.getNumReady(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i) {
+            applyCommand(commands[(size_t) (start1 + i)]);
+        }
+        for (int i = 0; i < size2; ++i) {
+            applyCommand(commands[(size_t) (start2 + i)]);
+        }
+
+        commandFifo.finishedRead(size1 + size2);
+    }
+
+    void applyCommand(const Command& command)
+    {
+        switch (command.type) {
+            case Command::Type::play:
+                break; // the atomic flag already flipped
+
+            case Command::Type::stop:
+                releaseAllVoices();
+                break;
+
+            case Command::Type::seek:
+                playheadSamples = (int64) (command.seekTime * sampleRate);
+                releaseAllVoices();
+                eventsChanged = true; // re-locate under the event lock
+                break;
+        }
+    }
+
+    // points nextEventIdx at the first event at or after the playhead.
+    // call with eventLock held.
+    void relocateNextEvent()
+    {
+        double playheadTime = playheadSamples / sampleRate;
+
+        auto it = std::lower_bound(events.begin(), events.end(), playheadTime,
+                                   [](const NoteEvent& event, double t) { return event.time < t; });
+
+        nextEventIdx = (size_t) std::distance(events.begin(), it);
+    }
+
+    void noteOn(int noteNumber, int velocity)
+    {
+        // prefer a free voice; otherwise steal the quietest
+        Voice* chosen = nullptr;
+
+        for (auto& voice : voices) {
+            if (voice.note < 0) {
+                chosen = &voice;
+                break;
+            }
+
+            if (chosen == nullptr || voice.level < chosen->level) {
+                chosen = &voice;
+            }
+        }
+
+        chosen->note = noteNumber;
+        chosen->phase = 0.0;
+        chosen->phaseInc = MathConstants<double>::twoPi
+            * MidiMessage::getMidiNoteInHertz(noteNumber) / sampleRate;
+        chosen->gain = 0.2f * (float) velocity / 127.0f;
+        chosen->level = 0.0f;
+        chosen->targetLevel = 1.0f;
+    }
+
+    void noteOff(int noteNumber)
+    {
+        for (auto& voice : voices) {
+            if (voice.note == noteNumber && voice.targetLevel > 0.0f) {
+                voice.targetLevel = 0.0f;
+                break;
+            }
+        }
+    }
+
+    void releaseAllVoices()
+    {
+        for (auto& voice : voices) {
+            voice.targetLevel = 0.0f;
+        }
+    }
+
+    int countActiveVoices() const
+    {
+        int count = 0;
+
+        for (const auto& voice : voices) {
+            if (voice.note >= 0) {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    // additively renders all live voices (mono, into channel 0)
+    void renderVoices(AudioBuffer<float>& buffer, int startSample, int numSamples)
+    {
+        float* out = buffer.getWritePointer(0, startSample);
+
+        for (auto& voice : voices) {
+            if (voice.note < 0) {
+                continue;
+            }
+
+            for (int i = 0; i < numSamples; ++i) {
+                // one-pole ramp towards held/released - a few ms of
+                // attack/release, enough to keep edges click-free
+                voice.level += (voice.targetLevel - voice.level) * envelopeCoeff;
+
+                out[i] += (float) std::sin(voice.phase) * voice.gain * voice.level;
+
+                voice.phase += voice.phaseInc;
+
+                if (voice.phase >= MathConstants<double>::twoPi) {
+                    voice.phase -= MathConstants<double>::twoPi;
+                }
+            }
+
+            // fully faded out and released - free the voice
+            if (voice.targetLevel <= 0.0f && voice.level < 0.0005f) {
+                voice.note = -1;
+            }
+        }
+    }
+
+    static constexpr double minNoteLengthSecs = 0.1;
+    static constexpr float envelopeCoeff = 0.002f;
+
+    // UI <-> audio thread state
+    std::atomic<bool> playing {false};
+    std::atomic<double> positionSecs {0.0};
+
+    AbstractFifo commandFifo {32};
+    std::array<Command, 32> commands;
+
+    CriticalSection eventLock;
+    std::vector<NoteEvent> events;
+    double lastEventTime = 0.0;
+    bool eventsChanged = false;
+
+    // audio-thread-only state
+    double sampleRate = 44100.0;
+    int64 playheadSamples = 0;
+    size_t nextEventIdx = 0;
+
+    std::array<Voice, 32> voices;
+};
@@ -1,5 +1,7 @@
 // Adapted from https://github.com/Sjhunt93/Piano-Roll-Editor
 
+#include <algorithm>
+
 #include "NoteGridComponent.hpp"
 
 
@@ -7,12 +9,10 @@ NoteGridComponent::NoteGridComponent()
 {
     pixelsPerSecond = 0.0;
     lengthInSeconds = 0.0;
+    maxNoteDuration = 0.0;
 }
 
-NoteGridComponent::~NoteGridComponent()
-{
-    resetNotes();
-}
+NoteGridComponent::~NoteGridComponent() {}
 
 void NoteGridComponent::setResolution(double pps)
 {
@@ -33,42 +33,115 @@ void NoteGridComponent::updateSize()
     setSize(pixelsPerSecond * lengthInSeconds, getHeight());
 }
 
-void NoteGridComponent::resized()
+void NoteGridComponent::paint(Graphics& g)
 {
+    const Rectangle<int> clip = g.getClipBounds();
+
+    // the grid rows are uniform along the time axis, so a cached
+    // one-pixel-wide strip stretched over the clip region stands in for a
+    // full 128-row redraw on every scroll
+    if (gridImage.getHeight() != getHeight()) {
+        updateGridImage();
+    }
+
+    g.drawImage(gridImage,
+                clip.getX(), 0, clip.getWidth(), getHeight(),
+                0, 0, 1, gridImage.getHeight());
+
+    if (midiNotes.empty() || pixelsPerSecond <= 0.0) {
+        return;
+    }
+
     const float keyHeight = getKeyHeight();
 
-    for (auto n : midiNotes) {
-        const float xPos = ((float) n->getStartTime()) * pixelsPerSecond;
-        const float width = ((float) n->getNoteLength()) * pixelsPerSecond;
+    // only paint notes intersecting the visible time window. the vector is
+    // sorted by start time, so a binary search finds the window
+    const double clipStartTime = clip.getX() / pixelsPerSecond - maxNoteDuration;
+    const double clipEndTime = clip.getRight() / pixelsPerSecond;
+
+    auto firstNote = std::lower_bound(midiNotes.begin(), midiNotes.end(), clipStartTime,
+                                      [](const MidiNote& n, double t) { return n.startTime < t; });
 
-        const float yPos = getHeight() - ((1 + n->getNoteNumber()) * keyHeight);
+    for (auto it = firstNote; it != midiNotes.end() && it->startTime <= clipEndTime; ++it) {
+        const float yPos = getHeight() - ((1 + it->noteNumber) * keyHeight);
 
-        n->setBounds(xPos, yPos, width, keyHeight);
+        // pitch rows outside the vertical clip are culled too
+        if ((yPos + keyHeight) < clip.getY() || yPos > clip.getBottom()) {
+            continue;
+        }
+
+        paintNote(g, *it, keyHeight);
     }
 }
 
-void NoteGridComponent::insertNote(MidiNoteComponent n)
+void NoteGridComponent::updateGridImage()
 {
-    MidiNoteComponent* note = new MidiNoteComponent(n);
-    midiNotes.add(note);
+    gridImage = Image(Image::ARGB, 1, jmax(1, getHeight()), true);
 
-    addAndMakeVisible(note);
+    Graphics g(gridImage);
+    KeyboardComponent::paint(g);
+}
 
-    resized();
-    repaint();
+void NoteGridComponent::paintNote(Graphics& g, const MidiNote& n, float keyHeight)
+{
+    const float xPos = ((float) n.startTime) * pixelsPerSecond;
+    const float width = ((float) n.duration) * pixelsPerSecond;
+
+    const float yPos = getHeight() - ((1 + n.noteNumber) * keyHeight);
+
+    g.setColour(Colours::darkgrey);
+    g.fillRect(xPos, yPos, width, keyHeight);
+
+    Colour red(252, 97, 92);
+
+    g.setColour(red);
+    g.fillRect(xPos + 1, yPos + 1, jmax(width - 2, 0.0f), jmax(keyHeight - 2, 0.0f));
+
+    if (width > 10) {
+        g.setColour(red.brighter());
+
+        const float maxVelocityWidth = width - 10;
+        const float verticalPosition = yPos + keyHeight * 0.5f - 2;
+
+        g.drawLine(xPos + 5, verticalPosition, xPos + maxVelocityWidth * (n.velocity / 127.0f), verticalPosition, 4);
+    }
 }
 
-void NoteGridComponent::resetNotes()
+void NoteGridComponent::setNotes(std::vector<MidiNote> notes)
 {
-    for (int i = 0; i < midiNotes.size(); i++) {
-        MidiNoteComponent* note = midiNotes.getReference(i);
-        removeChildComponent(note);
+    midiNotes = std::move(notes);
+
+    // the flat store is kept sorted by start time (paint order and
+    // visible-range lookups rely on it)
+    std::sort(midiNotes.begin(), midiNotes.end(),
+              [](const MidiNote& a, const MidiNote& b) { return a.startTime < b.startTime; });
 
-        delete note;
+    maxNoteDuration = 0.0;
+
+    for (const auto& n : midiNotes) {
+        maxNoteDuration = jmax(maxNoteDuration, n.duration);
     }
 
+    repaint();
+}
+
+void NoteGridComponent::insertNote(const MidiNote& n)
+{
+    auto insertAt = std::upper_bound(midiNotes.begin(), midiNotes.end(), n,
+                                     [](const MidiNote& a, const MidiNote& b) { return a.startTime < b.startTime; });
+
+    midiNotes.insert(insertAt, n);
+
+    maxNoteDuration = jmax(maxNoteDuration, n.duration);
+
+    repaint();
+}
+
+void NoteGridComponent::resetNotes()
+{
     midiNotes.clear();
 
-    resized();
+    maxNoteDuration = 0.0;
+
     repaint();
 }
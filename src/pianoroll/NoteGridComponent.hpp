@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "juce_gui_basics/juce_gui_basics.h"
 
 #include "KeyboardComponent.hpp"
@@ -9,52 +11,10 @@
 using namespace juce;
 
 
-class MidiNoteComponent : public Component
+// a plain note record. deliberately free of any Component machinery, so a
+// dense performance can live in one flat, cache-friendly vector.
+struct MidiNote
 {
-public:
-
-    MidiNoteComponent(unsigned char n, unsigned char v, double s, double d)
-    {
-        noteNumber = n;
-        velocity = v;
-        startTime = s;
-        duration = d;
-    }
-
-    MidiNoteComponent(const MidiNoteComponent& other)
-    {
-        noteNumber = other.noteNumber;
-        velocity = other.velocity;
-        startTime = other.startTime;
-        duration = other.duration;
-    }
-
-    void paint(Graphics& g)
-    {
-        g.fillAll(Colours::darkgrey);
-
-        Colour red(252, 97, 92);
-
-        g.setColour(red);
-        g.fillRect(1, 1, getWidth() - 2, getHeight() - 2);
-
-        if (getWidth() > 10) {
-            g.setColour(red.brighter());
-
-            const int maxVelocityWidth = getWidth() - 10;
-            const int verticalPosition = getHeight() * 0.5 - 2;
-
-            g.drawLine(5, verticalPosition, maxVelocityWidth * (getVelocity() / 127.0), verticalPosition, 4);
-        }
-    }
-
-    unsigned char getNoteNumber() { return noteNumber; }
-    unsigned char getVelocity() { return velocity; }
-    double getStartTime() { return startTime; }
-    double getNoteLength() { return duration; }
-
-private:
-
     unsigned char noteNumber;
     unsigned char velocity;
     double startTime;
@@ -75,9 +35,11 @@ public:
     void updateLength(double l);
 
     void updateSize();
-    void resized() override;
 
-    void insertNote(MidiNoteComponent n);
+    void paint(Graphics& g) override;
+
+    void setNotes(std::vector<MidiNote> notes);
+    void insertNote(const MidiNote& n);
     void resetNotes();
 
     int getPixelsPerSecond() { return pixelsPerSecond; }
@@ -87,7 +49,19 @@ public:
 
 private:
 
-    Array<MidiNoteComponent*> midiNotes;
+    void paintNote(Graphics& g, const MidiNote& n, float keyHeight);
+
+    void updateGridImage();
+
+    std::vector<MidiNote> midiNotes; // sorted by start time
+
+    // longest note in midiNotes - bounds how far before the visible window
+    // a still-sounding note can start
+    double maxNoteDuration;
+
+    // cached one-pixel-wide strip of the grid rows, stretched across the
+    // visible region at paint time
+    Image gridImage;
 
     double pixelsPerSecond;
     double lengthInSeconds;
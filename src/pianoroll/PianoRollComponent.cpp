@@ -10,6 +10,11 @@ PianoRollComponent::PianoRollComponent(int _keyboardWidth, int _scrollBarSize, i
     scrollBarSpacing = _scrollBarSpacing;
 
     addAndMakeVisible(keyboard);
+
+    // the keyboard never changes between repaints - cache it so scrolling
+    // and the playback cursor just re-composite an image
+    keyboard.setBufferedToImage(true);
+
     addAndMakeVisible(noteGridContainer);
     noteGridContainer.addAndMakeVisible(noteGrid);
 
@@ -31,7 +36,7 @@ PianoRollComponent::PianoRollComponent(int _keyboardWidth, int _scrollBarSize, i
 
 PianoRollComponent::~PianoRollComponent() {}
 
-int PianoRollComponent::getPianoRollWidth()
+int PianoRollComponent::getPianoRollWidth() const
 {
     return getWidth() - keyboardWidth - 5 - (2 * scrollBarSize + 4 * scrollBarSpacing);
 }
@@ -122,7 +127,12 @@ void PianoRollComponent::visibleKeyRangeZoom(double amount)
     updateVisibleKeyRange(fullKeyRange.constrainRange(newRange));
 }
 
-void PianoRollComponent::insertNote(MidiNoteComponent n)
+void PianoRollComponent::setNotes(std::vector<MidiNote> notes)
+{
+    noteGrid.setNotes(std::move(notes));
+}
+
+void PianoRollComponent::insertNote(const MidiNote& n)
 {
     noteGrid.insertNote(n);
 }
@@ -23,7 +23,7 @@ public:
 
     ~PianoRollComponent();
 
-    int getPianoRollWidth();
+    int getPianoRollWidth() const;
 
     void setResolution(int pixelsPerSecond);
 
@@ -39,12 +39,13 @@ public:
 
     void visibleKeyRangeZoom(double amount);
 
-    void insertNote(MidiNoteComponent n);
+    void setNotes(std::vector<MidiNote> notes);
+    void insertNote(const MidiNote& n);
     void resetNotes();
 
-    int getKeyboardWidth() { return keyboardWidth; }
-    int getScrollBarSize() { return scrollBarSize; }
-    int getScrollBarSpacing() { return scrollBarSpacing; }
+    int getKeyboardWidth() const { return keyboardWidth; }
+    int getScrollBarSize() const { return scrollBarSize; }
+    int getScrollBarSpacing() const { return scrollBarSpacing; }
 
 private:
 